@@ -0,0 +1,167 @@
+// batch.c — run many (workload, algorithm, quantum) jobs in parallel
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+#include "trace.h"
+#include "report.h"
+#include "threadpool.h"
+
+typedef struct {
+    // input
+    char        input[256];
+    const policy_ops_t *policy;
+    int         quantum;
+    const cmd_options_t *opts;   // engine, workers and policy parameters
+    int         line;        // manifest line, for error messages
+    // result
+    int         ok;
+    int         nprocs, makespan;
+    metrics_acc_t acc;
+    metrics_t   m;
+} batch_job_t;
+
+static void trim(char *s) {
+    size_t n = strlen(s), k = 0;
+    while (n && (s[n-1]=='\n' || s[n-1]=='\r' || s[n-1]==' ' || s[n-1]=='\t')) s[--n] = 0;
+    while (s[k]==' ' || s[k]=='\t') k++;
+    if (k) memmove(s, s + k, n - k + 1);
+}
+
+// Each job owns its procs[] and runs through a reentrant engine, so jobs can
+// run on any pool thread concurrently.
+static void run_job(void *arg) {
+    batch_job_t *J = (batch_job_t*)arg;
+    proc_table_t procs;
+
+    if (load_workload(J->input, &procs) != 0 || procs.n == 0) {
+        fprintf(stderr, "batch line %d: failed to load %s\n", J->line, J->input);
+        pt_free(&procs);
+        return;
+    }
+    pt_reset(&procs);
+
+    sched_params_t sp;
+    options_sched_params(J->opts, J->quantum, &sp);
+
+    int makespan;
+    macc_init(&J->acc);
+    switch (J->opts->engine) {
+        case ENGINE_EVENT:  makespan = run_scheduler_events(&procs, J->policy, &sp, &J->acc, NULL, NULL, NULL); break;
+        case ENGINE_INLINE: makespan = run_scheduler_inline(&procs, J->policy, &sp, &J->acc, NULL, NULL, NULL); break;
+        default:            makespan = run_scheduler(&procs, J->policy, &sp, J->opts->workers, &J->acc, NULL, NULL, NULL); break;
+    }
+
+    J->m = metrics_from_acc(&J->acc, makespan, 1);
+    J->nprocs = procs.n;
+    J->makespan = makespan;
+    J->ok = 1;
+    pt_free(&procs);
+}
+
+static int load_manifest(const char *path, const cmd_options_t *opts, batch_job_t **out_jobs, int *out_n) {
+    FILE *f = fopen(path, "r");
+    if (!f) { perror("fopen"); return -1; }
+
+    batch_job_t *jobs = NULL;
+    int n = 0, cap = 0, lineno = 0;
+    char line[512];
+    while (fgets(line, sizeof line, f)) {
+        lineno++;
+        trim(line);
+        if (line[0] == '#' || line[0] == 0) continue;
+
+        char input[256], alg[32]; int quantum = 0;
+        int got = sscanf(line, " %255[^,] , %31[^,] , %d", input, alg, &quantum);
+        if (got < 2) {
+            fprintf(stderr, "Bad batch row %d: %s\n", lineno, line);
+            free(jobs); fclose(f); return -1;
+        }
+        trim(input); trim(alg);
+
+        const policy_ops_t *policy = policy_find(alg);
+        if (!policy || (policy->needs_quantum && quantum <= 0)) {
+            if (!policy) fprintf(stderr, "Bad batch row %d: %s (unknown algorithm '%s')\n", lineno, line, alg);
+            else         fprintf(stderr, "Bad batch row %d: %s (%s needs a quantum)\n", lineno, line, policy->name);
+            free(jobs); fclose(f); return -1;
+        }
+
+        if (n == cap) {
+            cap = cap ? cap * 2 : 64;
+            jobs = (batch_job_t*)realloc(jobs, sizeof(batch_job_t) * cap);
+        }
+        memset(&jobs[n], 0, sizeof jobs[n]);
+        snprintf(jobs[n].input, sizeof jobs[n].input, "%s", input);
+        jobs[n].policy = policy;
+        jobs[n].quantum = quantum;
+        jobs[n].opts = opts;
+        jobs[n].line = lineno;
+        n++;
+    }
+    fclose(f);
+
+    *out_jobs = jobs;
+    *out_n = n;
+    return 0;
+}
+
+int run_batch(const cmd_options_t *opts) {
+    const char *manifest = opts->batch_file;
+    int nthreads = opts->jobs;
+    batch_job_t *jobs = NULL;
+    int njobs = 0;
+    if (load_manifest(manifest, opts, &jobs, &njobs) != 0) return 1;
+    if (njobs == 0) {
+        fprintf(stderr, "No jobs found in %s\n", manifest);
+        return 1;
+    }
+
+    if (nthreads <= 0) nthreads = tp_default_threads();
+    if (nthreads > njobs) nthreads = njobs;
+
+    tpool_t *tp = tp_create(nthreads);
+    if (!tp) {
+        fprintf(stderr, "Could not start the batch thread pool\n");
+        free(jobs);
+        return 1;
+    }
+    nthreads = tp_threads(tp);
+    for (int k = 0; k < njobs; ++k) tp_submit(tp, run_job, &jobs[k]);
+    tp_destroy(tp);
+
+    // aggregated results, in manifest order
+    printf("\n===== Batch: %d jobs on %d threads =====\n", njobs, nthreads);
+    printf("%-28s %-9s %4s %7s %9s %9s %9s %9s %9s %9s %8s %6s\n",
+           "Input", "Alg", "Q", "Procs", "Makespan", "AvgWait", "P99Wait", "MaxWait", "AvgResp", "AvgTurn",
+           "Thruput", "CPU%");
+    int failed = 0;
+    metrics_acc_t *all = (metrics_acc_t*)malloc(sizeof *all);
+    macc_init(all);
+    for (int k = 0; k < njobs; ++k) {
+        const batch_job_t *J = &jobs[k];
+        if (!J->ok) {
+            printf("%-28s %-9s %4d %7s\n", J->input, J->policy->label, J->quantum, "FAILED");
+            failed++;
+            continue;
+        }
+        printf("%-28s %-9s %4d %7d %9d %9.2f %9d %9d %9.2f %9.2f %8.3f %5.1f%%\n",
+               J->input, J->policy->label, J->quantum, J->nprocs, J->makespan,
+               J->m.avg_wait, J->m.wait.p99, J->m.max_wait, J->m.avg_resp, J->m.avg_turn,
+               J->m.throughput, J->m.cpu_utilization);
+        macc_merge(all, &J->acc);
+    }
+
+    // every completed proc of every job as one population
+    if (failed < njobs) {
+        metrics_t M = metrics_from_acc(all, 0, 1);
+        printf("\nAll %d jobs, %lld procs:", njobs - failed, M.nprocs);
+        outbuf_t ob;
+        ob_init(&ob, stdout);
+        report_percentiles(&ob, &M);
+        ob_close(&ob);
+    }
+    free(all);
+
+    free(jobs);
+    return failed ? 1 : 0;
+}
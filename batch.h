@@ -0,0 +1,16 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "cmdparser.h"
+
+// Run every job in a manifest on a work-stealing pool and print one results
+// table. Manifest lines are "input,algorithm[,quantum]" (algorithm is a
+// registered policy name, e.g. fcfs|sjf|srtf|rr|priority|mlfq|cfs; '#' starts
+// a comment). nthreads <= 0 = one per core.
+// Returns 0 when every job succeeded.
+// Uses opts' batch_file, engine, jobs (pool threads) and workers (each
+// threaded job's pool size, see run_scheduler); every job gets the CLI's
+// policy parameters (--levels, --aging, ...) with its own quantum.
+int run_batch(const cmd_options_t *opts);
+
+#endif
@@ -0,0 +1,52 @@
+// csv_load_bench.c — load_csv throughput (GB/s and rows/s).
+//
+// Usage: csv_load_bench [file] [reps]
+// Without a file, writes a synthetic 2M-row trace to /tmp first.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "../csvloader.h"
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    const char *path = (argc > 1) ? argv[1] : "/tmp/csv_load_bench.csv";
+    int reps = (argc > 2) ? atoi(argv[2]) : 5;
+
+    if (argc <= 1) {
+        FILE *f = fopen(path, "w");
+        if (!f) { perror("fopen"); return 1; }
+        fprintf(f, "# pid,arrival,burst,priority\n");
+        unsigned x = 12345;
+        for (int i = 0, t = 0; i < 2000000; ++i) {
+            x = x * 1103515245u + 12345u;
+            t += (x >> 16) % 7;
+            fprintf(f, "P%d,%d,%u,%u\n", i, t, 1 + (x >> 8) % 100, (x >> 4) % 10);
+        }
+        fclose(f);
+    }
+
+    struct stat st;
+    if (stat(path, &st) != 0) { perror("stat"); return 1; }
+
+    double best = 1e30;
+    int n = 0;
+    for (int r = 0; r < reps; ++r) {
+        proc_table_t procs;
+        double t0 = now_s();
+        if (load_csv(path, &procs) != 0) return 1;
+        double dt = now_s() - t0;
+        if (dt < best) best = dt;
+        n = procs.n;
+        pt_free(&procs);
+    }
+
+    printf("%s: %d rows, %.1f MB, best of %d: %.3f s  %.3f GB/s  %.1f Mrows/s\n",
+           path, n, st.st_size / 1e6, reps, best, st.st_size / best / 1e9, n / best / 1e6);
+    return 0;
+}
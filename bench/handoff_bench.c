@@ -0,0 +1,125 @@
+// handoff_bench.c — scheduler <-> worker handoff latency, gate_t vs handoff_t.
+//
+// Part 1 ping-pongs two threads the way the threaded engine hands out work:
+// the scheduler posts a grant and waits for the worker's done. gate_t is the
+// old mutex + condvar per-tick handoff; handoff_t is the atomic slot with
+// adaptive spin. One round trip is what every simulated tick used to cost.
+//
+// Part 2 runs the threaded engine on a synthetic workload and reports wall
+// time per simulated tick and per run (a timeline segment, i.e. a stretch on
+// one proc): with multi-tick slices a tick no longer costs a round trip, a
+// slice does.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../scheduler_wiring.h"
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+typedef struct {
+    gate_t    g_run, g_done;
+    handoff_t h_run, h_done;
+    int       rounds;
+} pingpong_t;
+
+static void *gate_worker(void *arg) {
+    pingpong_t *P = (pingpong_t*)arg;
+    for (int k = 0; k < P->rounds; ++k) {
+        gate_wait(&P->g_run);
+        gate_post(&P->g_done);
+    }
+    return NULL;
+}
+
+static void *handoff_worker(void *arg) {
+    pingpong_t *P = (pingpong_t*)arg;
+    for (int k = 0; k < P->rounds; ++k) {
+        int v = handoff_wait(&P->h_run);
+        handoff_post(&P->h_done, v);
+    }
+    return NULL;
+}
+
+static double pingpong(bool use_handoff, int spin_max, int rounds) {
+    pingpong_t P;
+    P.rounds = rounds;
+    gate_init(&P.g_run, 0); gate_init(&P.g_done, 0);
+    handoff_init(&P.h_run, spin_max); handoff_init(&P.h_done, spin_max);
+
+    pthread_t th;
+    pthread_create(&th, NULL, use_handoff ? handoff_worker : gate_worker, &P);
+    double t0 = now_ns();
+    for (int k = 0; k < rounds; ++k) {
+        if (use_handoff) {
+            handoff_post(&P.h_run, 1);
+            handoff_wait(&P.h_done);
+        } else {
+            gate_post(&P.g_run);
+            gate_wait(&P.g_done);
+        }
+    }
+    double per = (now_ns() - t0) / rounds;
+    pthread_join(th, NULL);
+
+    gate_destroy(&P.g_run); gate_destroy(&P.g_done);
+    handoff_destroy(&P.h_run); handoff_destroy(&P.h_done);
+    return per;
+}
+
+// n procs, arrivals spread over the first n ticks, bursts 1..64
+static void synth(proc_table_t *t, int n) {
+    pt_init(t);
+    pt_reserve(t, n);
+    srand(42);
+    for (int i = 0; i < n; ++i) {
+        char pid[16];
+        int len = snprintf(pid, sizeof pid, "P%d", i);
+        pt_append(t, pid, len, rand() % (n > 0 ? n : 1), 1 + rand() % 64, rand() % 10);
+    }
+}
+
+static void engine_row(proc_table_t *t, const char *name, int quantum) {
+    sched_params_t sp;
+    sched_params_init(&sp, quantum);
+    tl_seg_t *segs = NULL; int nsegs = 0;
+    pt_reset(t);
+    double t0 = now_ns();
+    int makespan = run_scheduler(t, policy_find(name), &sp, 0, NULL, NULL, &segs, &nsegs);
+    double ns = now_ns() - t0;
+    int busy_segs = 0;
+    for (int k = 0; k < nsegs; ++k) busy_segs += segs[k].proc >= 0;
+    printf("%-10s %4d  %9d  %9d  %12.1f  %12.1f\n", name, quantum, makespan, busy_segs,
+           ns / makespan, busy_segs ? ns / busy_segs : 0.0);
+    free(segs);
+}
+
+int main(int argc, char **argv) {
+    int rounds = (argc > 1) ? atoi(argv[1]) : 200000;
+    int nprocs = (argc > 2) ? atoi(argv[2]) : 500;
+
+    printf("round trip (post grant + wait done), %d rounds\n", rounds);
+    printf("%16s  %12s\n", "handoff", "ns/round");
+    printf("%16s  %12.1f\n", "gate_t", pingpong(false, 0, rounds));
+    printf("%16s  %12.1f\n", "handoff_t", pingpong(true, 0, rounds));
+    if (sysconf(_SC_NPROCESSORS_ONLN) > 1)
+        printf("%16s  %12.1f\n", "handoff_t + spin", pingpong(true, HANDOFF_SPIN_MAX, rounds));
+    else
+        printf("%16s  %12s\n", "handoff_t + spin", "n/a (1 CPU)");
+
+    proc_table_t t;
+    synth(&t, nprocs);
+    printf("\nthreaded engine, %d procs\n", nprocs);
+    printf("%-10s %4s  %9s  %9s  %12s  %12s\n", "policy", "q", "ticks", "runs", "ns/tick", "ns/run");
+    engine_row(&t, "fcfs", 0);
+    engine_row(&t, "rr", 1);
+    engine_row(&t, "rr", 8);
+    engine_row(&t, "mlfq", 2);
+    pt_free(&t);
+    return 0;
+}
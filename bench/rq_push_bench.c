@@ -0,0 +1,47 @@
+// rq_push_bench.c — per-push cost of the FIFO ready queue vs. queue depth.
+//
+// For each depth N the queue is filled with N procs, then we time the two
+// pushes the engines issue on every scheduling decision:
+//   dup     rq_push of a proc that is already queued (rejected)
+//   requeue rq_pop_fcfs + rq_push of the popped proc (RR rotation)
+// Both should stay flat as N grows.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../scheduler_wiring.h"
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+    int ops = (argc > 1) ? atoi(argv[1]) : 2000000;
+    static const int depths[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+    volatile int sink = 0;
+
+    printf("%10s  %12s  %12s\n", "depth", "dup ns/op", "requeue ns/op");
+    for (size_t d = 0; d < sizeof depths / sizeof depths[0]; ++d) {
+        int n = depths[d];
+        readyq_t q; rq_init(&q, n);
+        for (int i = 0; i < n; ++i) rq_push(&q, i);
+
+        double t0 = now_ns();
+        for (int k = 0; k < ops; ++k) rq_push(&q, k % n);
+        double dup = (now_ns() - t0) / ops;
+
+        t0 = now_ns();
+        for (int k = 0; k < ops; ++k) {
+            int i = rq_pop_fcfs(&q);
+            rq_push(&q, i);
+            sink += i;
+        }
+        double requeue = (now_ns() - t0) / ops;
+
+        printf("%10d  %12.1f  %12.1f\n", n, dup, requeue);
+        rq_destroy(&q);
+    }
+    (void)sink;
+    return 0;
+}
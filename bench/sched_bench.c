@@ -0,0 +1,272 @@
+// sched_bench.c — engine benchmark on seeded synthetic workloads.
+//
+// Usage: sched_bench [-n sizes] [-d exp|bimodal|pareto] [-s seed] [-e engine]
+//                    [-q quantum] [-P policies] [-j out.json] [-B baseline.json] [-t tolerance]
+//
+// For every size (comma separated, 1e6 style accepted) a workload is
+// generated (tools/wlgen.h) and written as CSV, then for every policy the
+// three phases of a sched run are timed separately: load (load_workload),
+// simulate (the chosen engine, timeline on), report (full text report to
+// /dev/null). Small sizes are repeated and the best time kept. Per row:
+// ns per simulated tick, ns per dispatch (a timeline run on one proc) and
+// the process's peak RSS so far.
+//
+// -j writes the rows as JSON, one result per line, for keeping as a
+// baseline; -B compares simulate times with such a file and exits 1 if a
+// row got slower by more than the tolerance (default 10%) and 1 ms.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../scheduler_wiring.h"
+#include "../metrics.h"
+#include "../report.h"
+#include "../trace.h"
+#include "../tools/wlgen.h"
+
+#define MAX_SIZES    16
+#define MAX_POLICIES 32
+#define MAX_BASELINE 1024
+
+typedef struct {
+    long   size;
+    char   policy[32];
+    double sim_ms;
+} baseline_row_t;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;   // KiB on Linux
+}
+
+// Enough repetitions that a small size still takes measurable time
+static int reps_for(long size) {
+    if (size >= 100000) return 1;
+    long r = 1000000 / (size > 0 ? size : 1);
+    return r > 200 ? 200 : (int)r;
+}
+
+static int simulate(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                    engine_t engine, metrics_acc_t *acc, tl_seg_t **segs, int *nsegs) {
+    switch (engine) {
+        case ENGINE_EVENT:  return run_scheduler_events(procs, policy, sp, acc, NULL, segs, nsegs);
+        case ENGINE_INLINE: return run_scheduler_inline(procs, policy, sp, acc, NULL, segs, nsegs);
+        default:            return run_scheduler(procs, policy, sp, 0, acc, NULL, segs, nsegs);
+    }
+}
+
+// Rows of a file written with -j: the fields we compare, by key
+static int load_baseline(const char *path, baseline_row_t *rows, int max) {
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return -1; }
+    char line[1024];
+    int n = 0;
+    while (n < max && fgets(line, sizeof line, f)) {
+        const char *sz = strstr(line, "\"size\":"), *po = strstr(line, "\"policy\":\""),
+                   *sm = strstr(line, "\"sim_ms\":");
+        if (!sz || !po || !sm) continue;
+        baseline_row_t *b = &rows[n];
+        b->size = strtol(sz + 7, NULL, 10);
+        if (sscanf(po + 10, "%31[^\"]", b->policy) != 1) continue;
+        b->sim_ms = strtod(sm + 9, NULL);
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+static const baseline_row_t *baseline_find(const baseline_row_t *rows, int n, long size, const char *policy) {
+    for (int k = 0; k < n; ++k)
+        if (rows[k].size == size && strcmp(rows[k].policy, policy) == 0) return &rows[k];
+    return NULL;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n sizes] [-d exp|bimodal|pareto] [-s seed] [-e threaded|inline|event]\n"
+                    "       [-q quantum] [-P policy,...] [-j out.json] [-B baseline.json] [-t tolerance]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    wl_params_t wp;
+    wl_defaults(&wp);
+    long sizes[MAX_SIZES] = { 10, 1000, 100000 };
+    int nsizes = 3;
+    engine_t engine = ENGINE_EVENT;
+    int quantum = 4;
+    const policy_ops_t *policies[MAX_POLICIES];
+    int npolicies = 0;
+    const char *json_path = NULL, *baseline_path = NULL;
+    double tolerance = 0.10;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:s:e:q:P:j:B:t:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                nsizes = 0;
+                for (char *tok = strtok(optarg, ","); tok && nsizes < MAX_SIZES; tok = strtok(NULL, ","))
+                    if ((sizes[nsizes] = (long)strtod(tok, NULL)) > 0) nsizes++;
+                break;
+            case 'd':
+                if (wl_parse_dist(optarg, &wp.dist) != 0) { usage(argv[0]); return 2; }
+                break;
+            case 's': wp.seed = strtoull(optarg, NULL, 10); break;
+            case 'e':
+                if (strcmp(optarg, "threaded") == 0)    engine = ENGINE_THREADED;
+                else if (strcmp(optarg, "inline") == 0) engine = ENGINE_INLINE;
+                else if (strcmp(optarg, "event") == 0)  engine = ENGINE_EVENT;
+                else { usage(argv[0]); return 2; }
+                break;
+            case 'q': quantum = atoi(optarg); break;
+            case 'P':
+                for (char *tok = strtok(optarg, ","); tok && npolicies < MAX_POLICIES; tok = strtok(NULL, ",")) {
+                    if (!(policies[npolicies] = policy_find(tok))) {
+                        fprintf(stderr, "unknown policy '%s'\n", tok);
+                        return 2;
+                    }
+                    npolicies++;
+                }
+                break;
+            case 'j': json_path = optarg; break;
+            case 'B': baseline_path = optarg; break;
+            case 't': tolerance = atof(optarg); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (nsizes == 0 || quantum <= 0) { usage(argv[0]); return 2; }
+    if (npolicies == 0)
+        for (int k = 0; k < policy_count() && k < MAX_POLICIES; ++k) policies[npolicies++] = policy_at(k);
+
+    static baseline_row_t base[MAX_BASELINE];
+    int nbase = 0;
+    if (baseline_path && (nbase = load_baseline(baseline_path, base, MAX_BASELINE)) < 0) return 2;
+
+    FILE *json = NULL;
+    if (json_path) {
+        if (!(json = fopen(json_path, "w"))) { perror(json_path); return 2; }
+        fprintf(json, "{\"bench\":\"sched_bench\",\"version\":1,\"dist\":\"%s\",\"seed\":%llu,"
+                      "\"engine\":\"%s\",\"quantum\":%d,\"results\":[\n",
+                wl_dist_name(wp.dist), (unsigned long long)wp.seed,
+                engine == ENGINE_EVENT ? "event" : engine == ENGINE_INLINE ? "inline" : "threaded", quantum);
+    }
+
+    const char *tmp = getenv("TMPDIR");
+    if (!tmp || !*tmp) tmp = "/tmp";
+    printf("%s bursts (mean %.0f), load %.2f, seed %llu, %s engine, quantum %d\n",
+           wl_dist_name(wp.dist), wp.mean_burst, wp.load, (unsigned long long)wp.seed,
+           engine == ENGINE_EVENT ? "event" : engine == ENGINE_INLINE ? "inline" : "threaded", quantum);
+    printf("%9s %-9s %10s %10s %10s %12s %10s %9s %9s %8s%s\n", "procs", "policy", "load ms", "sim ms",
+           "report ms", "ticks", "dispatch", "ns/tick", "ns/disp", "rss MiB", baseline_path ? "  vs base" : "");
+
+    int regressions = 0, first_row = 1;
+    for (int si = 0; si < nsizes; ++si) {
+        long size = sizes[si];
+        wp.n = size;
+        char path[512];
+        snprintf(path, sizeof path, "%s/sched_bench_%d_%ld.csv", tmp, (int)getpid(), size);
+
+        proc_table_t procs;
+        wl_generate(&wp, &procs);
+        int rc = wl_write_csv(path, &procs);
+        pt_free(&procs);
+        if (rc != 0) return 1;
+
+        int reps = reps_for(size);
+        double load_ns = 1e300;
+        for (int r = 0; r < reps; ++r) {
+            proc_table_t t;
+            double t0 = now_ns();
+            int bad = load_workload(path, &t) != 0;
+            double dt = now_ns() - t0;
+            if (bad) { unlink(path); return 1; }
+            if (dt < load_ns) load_ns = dt;
+            if (r + 1 < reps) pt_free(&t); else procs = t;
+        }
+        unlink(path);
+
+        for (int pi = 0; pi < npolicies; ++pi) {
+            const policy_ops_t *pol = policies[pi];
+            sched_params_t sp;
+            sched_params_init(&sp, quantum);
+
+            double sim_ns = 1e300, rep_ns = 1e300;
+            int makespan = 0;
+            long dispatches = 0;
+            static metrics_acc_t acc;   // ~80 KB of histograms
+            for (int r = 0; r < reps; ++r) {
+                tl_seg_t *segs = NULL; int nsegs = 0;
+                pt_reset(&procs);
+                macc_init(&acc);
+                double t0 = now_ns();
+                makespan = simulate(&procs, pol, &sp, engine, &acc, &segs, &nsegs);
+                double dt = now_ns() - t0;
+                if (dt < sim_ns) sim_ns = dt;
+
+                t0 = now_ns();
+                report_t *rep = report_open(OUTPUT_TEXT, "/dev/null", true, true);
+                if (!rep) return 1;
+                report_info_t info = { pol->label, 1, NULL, false, makespan, procs.n };
+                report_begin(rep, &info);
+                report_timeline(rep, 0, segs, nsegs, &procs);
+                report_rows(rep, &procs);
+                metrics_t M = metrics_from_acc(&acc, makespan, 1);
+                int w = M.max_wait_proc;
+                report_summary(rep, &M, makespan, w >= 0 ? pt_pid(&procs, w) : NULL,
+                               w >= 0 ? pt_pid_len(&procs, w) : 0, -1);
+                report_close(rep);
+                dt = now_ns() - t0;
+                if (dt < rep_ns) rep_ns = dt;
+
+                dispatches = 0;
+                for (int k = 0; k < nsegs; ++k) dispatches += segs[k].proc >= 0;
+                free(segs);
+            }
+
+            double sim_ms = sim_ns / 1e6;
+            double ns_tick = makespan > 0 ? sim_ns / makespan : 0.0;
+            double ns_disp = dispatches > 0 ? sim_ns / dispatches : 0.0;
+            long rss = peak_rss_kb();
+            printf("%9ld %-9s %10.3f %10.3f %10.3f %12d %10ld %9.1f %9.1f %8.1f", size, pol->name,
+                   load_ns / 1e6, sim_ms, rep_ns / 1e6, makespan, dispatches, ns_tick, ns_disp, rss / 1024.0);
+            if (baseline_path) {
+                const baseline_row_t *b = baseline_find(base, nbase, size, pol->name);
+                if (!b || b->sim_ms <= 0) {
+                    printf("       new");
+                } else {
+                    double delta = sim_ms / b->sim_ms - 1.0;
+                    int slow = delta > tolerance && sim_ms - b->sim_ms > 1.0;
+                    printf("  %+7.1f%%%s", 100.0 * delta, slow ? " SLOWER" : "");
+                    regressions += slow;
+                }
+            }
+            printf("\n");
+            fflush(stdout);
+
+            if (json) {
+                fprintf(json, "%s{\"size\":%ld,\"policy\":\"%s\",\"load_ms\":%.3f,\"sim_ms\":%.3f,"
+                              "\"report_ms\":%.3f,\"ticks\":%d,\"dispatches\":%ld,\"ns_per_tick\":%.2f,"
+                              "\"ns_per_dispatch\":%.2f,\"peak_rss_kb\":%ld}",
+                        first_row ? "" : ",\n", size, pol->name, load_ns / 1e6, sim_ms, rep_ns / 1e6,
+                        makespan, dispatches, ns_tick, ns_disp, rss);
+                first_row = 0;
+            }
+        }
+        pt_free(&procs);
+    }
+
+    if (json) {
+        fprintf(json, "\n]}\n");
+        if (fclose(json) != 0) { perror(json_path); return 1; }
+    }
+    if (regressions) fprintf(stderr, "%d row(s) slower than the baseline by more than %.0f%%\n",
+                             regressions, 100.0 * tolerance);
+    return regressions ? 1 : 0;
+}
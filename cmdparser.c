@@ -1,13 +1,32 @@
 #include "cmdparser.h"
+#include "scheduler_wiring.h"   // policy registry
+#include "stats.h"              // stats_available
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <getopt.h>
 
+// Long-only options
+enum { OPT_OUTPUT = 256, OPT_OUT_FILE, OPT_QUIET_GANTT, OPT_SUMMARY_ONLY, OPT_STATS, OPT_VERIFY, OPT_FUZZ };
+
 cmd_options_t parse_arguments(int argc, char *argv[]) {
     cmd_options_t opts = {
-        .scheduler = SCHED_NONE,
+        .policy = NULL,
         .quantum = 0,
+        .engine = ENGINE_THREADED,
+        .jobs = 0,
+        .q_step = 0,
+        .stream = false,
+        .reorder_window = 0,
+        .cpus = 1,
+        .rq_policy = RQ_POLICY_PERCPU,
+        .balance = BALANCE_IDLE,
+        .balance_interval = 100,
+        .mlfq_levels = 0,
+        .mlfq_boost = -1,
+        .output = OUTPUT_TEXT,
+        .fuzz_seed = 1,
         .show_help = false
     };
 
@@ -16,23 +35,168 @@ cmd_options_t parse_arguments(int argc, char *argv[]) {
         {"sjf",      no_argument,       0, 's'},
         {"rr",       no_argument,       0, 'r'},
         {"priority", no_argument,       0, 'p'},
+        {"mlfq",     no_argument,       0, 'm'},
+        {"srtf",     no_argument,       0, 't'},
+        {"aging",    required_argument, 0, 'A'},
+        {"cfs",      no_argument,       0, 'C'},
+        {"policy",   required_argument, 0, 'P'},
+        {"latency",  required_argument, 0, 'l'},
+        {"min-gran", required_argument, 0, 'g'},
+        {"levels",   required_argument, 0, 'L'},
+        {"level-quanta", required_argument, 0, 'T'},
+        {"boost",    required_argument, 0, 'O'},
         {"input",    required_argument, 0, 'i'},
         {"quantum",  required_argument, 0, 'q'},
+        {"engine",   required_argument, 0, 'e'},
+        {"batch",    required_argument, 0, 'b'},
+        {"jobs",     required_argument, 0, 'j'},
+        {"workers",  required_argument, 0, 'w'},
+        {"quantum-range", required_argument, 0, 'Q'},
+        {"stream",   no_argument,       0, 'S'},
+        {"reorder-window", required_argument, 0, 'W'},
+        {"cpus",     required_argument, 0, 'c'},
+        {"rq",       required_argument, 0, 'R'},
+        {"balance",  required_argument, 0, 'B'},
+        {"output",   required_argument, 0, OPT_OUTPUT},
+        {"out-file", required_argument, 0, OPT_OUT_FILE},
+        {"quiet-gantt",  no_argument,   0, OPT_QUIET_GANTT},
+        {"summary-only", no_argument,   0, OPT_SUMMARY_ONLY},
+        {"stats",        no_argument,   0, OPT_STATS},
+        {"verify",       no_argument,   0, OPT_VERIFY},
+        {"fuzz",     required_argument, 0, OPT_FUZZ},
         {"help",     no_argument,       0, 'h'},
         {0, 0, 0, 0}
     };
 
     int opt;
     int opt_index = 0;
+    const char *policy_name = NULL;   // resolved once all options are read
+    bool engine_given = false;        // --engine on the command line, not the default
 
-    while ((opt = getopt_long(argc, argv, "fsrpi:q:h", long_opts, &opt_index)) != -1) {
+    while ((opt = getopt_long(argc, argv, "fsrpmtCP:i:q:Q:e:b:j:w:SW:c:R:B:L:T:O:A:l:g:h", long_opts, &opt_index)) != -1) {
         switch (opt) {
-            case 'f': opts.scheduler = SCHED_FCFS; break;
-            case 's': opts.scheduler = SCHED_SJF; break;
-            case 'r': opts.scheduler = SCHED_RR; break;
-            case 'p': opts.scheduler = SCHED_PRIORITY; break;
+            case 'f': policy_name = "fcfs"; break;
+            case 's': policy_name = "sjf"; break;
+            case 'r': policy_name = "rr"; break;
+            case 'p': policy_name = "priority"; break;
+            case 'm': policy_name = "mlfq"; break;
+            case 't': policy_name = "srtf"; break;
+            case 'C': policy_name = "cfs"; break;
+            case 'P': policy_name = optarg; break;
+            case 'l':
+            case 'g': {
+                int v = atoi(optarg);
+                if (v <= 0) {
+                    fprintf(stderr, "Error: --%s expects a positive number of ticks\n",
+                            opt == 'l' ? "latency" : "min-gran");
+                    exit(EXIT_FAILURE);
+                }
+                if (opt == 'l') opts.cfs_latency = v; else opts.cfs_min_gran = v;
+                break;
+            }
+            case 'A':
+                if ((opts.aging = atoi(optarg)) <= 0) {
+                    fprintf(stderr, "Error: --aging expects a positive number of ticks\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'L':
+                opts.mlfq_levels = atoi(optarg);
+                if (opts.mlfq_levels < 1 || opts.mlfq_levels > MLFQ_MAX_LEVELS) {
+                    fprintf(stderr, "Error: --levels must be between 1 and %d\n", MLFQ_MAX_LEVELS);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'T': {
+                int k = 0;
+                for (char *tok = strtok(optarg, ","); tok; tok = strtok(NULL, ",")) {
+                    if (k == MLFQ_MAX_LEVELS || (opts.mlfq_quanta[k] = atoi(tok)) <= 0) {
+                        fprintf(stderr, "Error: --level-quanta expects up to %d positive quanta, e.g. 2,4,8\n",
+                                MLFQ_MAX_LEVELS);
+                        exit(EXIT_FAILURE);
+                    }
+                    k++;
+                }
+                if (opts.mlfq_levels == 0) opts.mlfq_levels = k;
+                break;
+            }
+            case 'O': opts.mlfq_boost = atoi(optarg); break;
             case 'i': strncpy(opts.input_file, optarg, sizeof(opts.input_file) - 1); break;
             case 'q': opts.quantum = atoi(optarg); break;
+            case 'e':
+                engine_given = true;
+                if (strcmp(optarg, "threaded") == 0)    opts.engine = ENGINE_THREADED;
+                else if (strcmp(optarg, "inline") == 0) opts.engine = ENGINE_INLINE;
+                else if (strcmp(optarg, "event") == 0)  opts.engine = ENGINE_EVENT;
+                else {
+                    fprintf(stderr, "Error: unknown engine '%s' (expected threaded, inline or event)\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'b': strncpy(opts.batch_file, optarg, sizeof(opts.batch_file) - 1); break;
+            case 'j': opts.jobs = atoi(optarg); break;
+            case 'w':
+                if ((opts.workers = atoi(optarg)) <= 0) {
+                    fprintf(stderr, "Error: --workers expects a positive number of threads\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'Q':
+                if (sscanf(optarg, "%d:%d:%d", &opts.q_lo, &opts.q_hi, &opts.q_step) != 3 ||
+                    opts.q_lo <= 0 || opts.q_hi < opts.q_lo || opts.q_step <= 0) {
+                    fprintf(stderr, "Error: --quantum-range expects lo:hi:step with 0 < lo <= hi, step > 0\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'S': opts.stream = true; break;
+            case 'W': opts.reorder_window = atoi(optarg); break;
+            case 'c': opts.cpus = atoi(optarg); break;
+            case 'R':
+                if (strcmp(optarg, "percpu") == 0)      opts.rq_policy = RQ_POLICY_PERCPU;
+                else if (strcmp(optarg, "global") == 0) opts.rq_policy = RQ_POLICY_GLOBAL;
+                else {
+                    fprintf(stderr, "Error: unknown --rq '%s' (expected percpu or global)\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'B':
+                if (strcmp(optarg, "none") == 0)      opts.balance = BALANCE_NONE;
+                else if (strcmp(optarg, "idle") == 0) opts.balance = BALANCE_IDLE;
+                else if (strncmp(optarg, "periodic", 8) == 0 &&
+                         (optarg[8] == 0 ||
+                          (optarg[8] == ':' && (opts.balance_interval = atoi(optarg + 9)) > 0)))
+                    opts.balance = BALANCE_PERIODIC;
+                else {
+                    fprintf(stderr, "Error: unknown --balance '%s' (expected none, idle or periodic[:ticks])\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case OPT_OUTPUT:
+                if (strcmp(optarg, "text") == 0)      opts.output = OUTPUT_TEXT;
+                else if (strcmp(optarg, "json") == 0) opts.output = OUTPUT_JSON;
+                else if (strcmp(optarg, "csv") == 0)  opts.output = OUTPUT_CSV;
+                else if (strcmp(optarg, "bin") == 0)  opts.output = OUTPUT_BIN;
+                else {
+                    fprintf(stderr, "Error: unknown --output '%s' (expected text, json, csv or bin)\n", optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case OPT_OUT_FILE: strncpy(opts.out_file, optarg, sizeof(opts.out_file) - 1); break;
+            case OPT_QUIET_GANTT: opts.quiet_gantt = true; break;
+            case OPT_SUMMARY_ONLY: opts.summary_only = true; break;
+            case OPT_STATS: opts.stats = true; break;
+            case OPT_VERIFY: opts.verify = true; break;
+            case OPT_FUZZ: {
+                char *end;
+                long n = strtol(optarg, &end, 10);
+                if (*end == ':') opts.fuzz_seed = strtoull(end + 1, &end, 10);
+                if (n <= 0 || n > 1000000 || *end != '\0') {
+                    fprintf(stderr, "Error: --fuzz expects <iterations>[:seed], e.g. 200 or 200:7\n");
+                    exit(EXIT_FAILURE);
+                }
+                opts.fuzz = (int)n;
+                break;
+            }
             case 'h': opts.show_help = true; break;
             default:
                 print_usage(argv[0]);
@@ -40,18 +204,89 @@ cmd_options_t parse_arguments(int argc, char *argv[]) {
         }
     }
 
-    // Validation
-    if (!opts.show_help) {
-        if (opts.scheduler == SCHED_NONE) {
-            fprintf(stderr, "Error: must specify a scheduling algorithm (--fcfs, --sjf, --rr, or --priority)\n");
+    if (policy_name && !(opts.policy = policy_find(policy_name))) {
+        fprintf(stderr, "Error: unknown policy '%s' (expected", policy_name);
+        for (int k = 0; k < policy_count(); ++k) fprintf(stderr, " %s", policy_at(k)->name);
+        fprintf(stderr, ")\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((strlen(opts.batch_file) > 0 || opts.q_step > 0) &&
+        (opts.output != OUTPUT_TEXT || strlen(opts.out_file) > 0 || opts.summary_only || opts.quiet_gantt)) {
+        fprintf(stderr, "Error: --output, --out-file, --quiet-gantt and --summary-only apply to single runs "
+                        "and --stream, not --batch or --quantum-range\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.stats && !stats_available()) {
+        fprintf(stderr, "Error: --stats needs a build with SCHED_STATS (make STATS=1)\n");
+        exit(EXIT_FAILURE);
+    }
+    if (opts.stats && (strlen(opts.batch_file) > 0 || opts.q_step > 0 || opts.stream)) {
+        fprintf(stderr, "Error: --stats applies to single runs, not --batch, --quantum-range or --stream\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (opts.fuzz > 0 && !opts.verify) {
+        fprintf(stderr, "Error: --fuzz is a --verify mode\n");
+        exit(EXIT_FAILURE);
+    }
+    if (opts.verify && (strlen(opts.batch_file) > 0 || opts.q_step > 0 || opts.stream || opts.cpus > 1 ||
+                        opts.output != OUTPUT_TEXT || strlen(opts.out_file) > 0 || opts.stats)) {
+        fprintf(stderr, "Error: --verify runs one workload through every single-CPU engine; it takes no "
+                        "--batch, --quantum-range, --stream, --cpus or report options\n");
+        exit(EXIT_FAILURE);
+    }
+    if (opts.fuzz > 0 && strlen(opts.input_file) > 0) {
+        fprintf(stderr, "Error: --fuzz generates its own workloads, drop -i\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Validation (a batch manifest carries its own inputs and algorithms)
+    // --fuzz draws its own policy parameters and runs every policy unless one is given
+    if (!opts.show_help && strlen(opts.batch_file) == 0 && opts.fuzz == 0) {
+        if (!opts.policy) {
+            fprintf(stderr, "Error: must specify a scheduling algorithm (--fcfs, --sjf, --srtf, --rr, --priority, --mlfq, --cfs or --policy <name>)\n");
             exit(EXIT_FAILURE);
         }
         if (strlen(opts.input_file) == 0) {
             fprintf(stderr, "Error: must specify an input file with -i or --input <file>\n");
             exit(EXIT_FAILURE);
         }
-        if (opts.scheduler == SCHED_RR && opts.quantum <= 0) {
-            fprintf(stderr, "Error: Round Robin requires a valid time quantum (--quantum <n>)\n");
+        if (opts.q_step > 0 && opts.policy != policy_find("rr")) {
+            fprintf(stderr, "Error: --quantum-range only applies to Round Robin (--rr)\n");
+            exit(EXIT_FAILURE);
+        }
+        if (opts.cpus < 1) {
+            fprintf(stderr, "Error: --cpus must be at least 1\n");
+            exit(EXIT_FAILURE);
+        }
+        if (opts.cpus > 1 && (opts.stream || opts.q_step > 0)) {
+            fprintf(stderr, "Error: --cpus cannot be combined with --stream or --quantum-range\n");
+            exit(EXIT_FAILURE);
+        }
+        if (opts.stream && opts.q_step > 0) {
+            fprintf(stderr, "Error: --stream cannot be combined with --quantum-range\n");
+            exit(EXIT_FAILURE);
+        }
+        if (opts.stream && ((engine_given && opts.engine != ENGINE_EVENT) || opts.workers > 0)) {
+            fprintf(stderr, "Error: --stream always runs the event engine; drop --engine and --workers or use event\n");
+            exit(EXIT_FAILURE);
+        }
+        if (opts.cpus > 1 && engine_given && opts.engine != ENGINE_EVENT) {
+            fprintf(stderr, "Error: --cpus always runs the event-driven SMP engine; drop --engine or use event\n");
+            exit(EXIT_FAILURE);
+        }
+        if (opts.aging > 0 && !opts.policy->uses_aging) {
+            fprintf(stderr, "Error: --aging does not apply to %s\n", opts.policy->label);
+            exit(EXIT_FAILURE);
+        }
+        if (opts.mlfq_boost < -1) {
+            fprintf(stderr, "Error: --boost must be 0 (off) or a positive number of ticks\n");
+            exit(EXIT_FAILURE);
+        }
+        if (opts.policy->needs_quantum && opts.quantum <= 0 && opts.q_step == 0) {
+            fprintf(stderr, "Error: %s requires a valid time quantum (--quantum <n>)\n", opts.policy->label);
             exit(EXIT_FAILURE);
         }
     }
@@ -59,13 +294,68 @@ cmd_options_t parse_arguments(int argc, char *argv[]) {
     return opts;
 }
 
+void options_sched_params(const cmd_options_t *opts, int quantum, sched_params_t *sp) {
+    // defaults derived from the quantum, then MLFQ / aging / CFS overrides
+    sched_params_init(sp, quantum);
+    if (opts->mlfq_levels > 0) sp->mlfq_levels = opts->mlfq_levels;
+    for (int l = 0; l < MLFQ_MAX_LEVELS; ++l) {
+        if (opts->mlfq_quanta[l] > 0) sp->mlfq_quantum[l] = opts->mlfq_quanta[l];
+        else if (l > 0)               sp->mlfq_quantum[l] = sp->mlfq_quantum[l - 1] * 2;
+    }
+    if (opts->mlfq_boost >= 0) sp->mlfq_boost = opts->mlfq_boost;
+    sp->aging = opts->aging;
+    if (opts->cfs_latency > 0)  sp->cfs_latency  = opts->cfs_latency;
+    if (opts->cfs_min_gran > 0) sp->cfs_min_gran = opts->cfs_min_gran;
+}
+
 void print_usage(const char *prog_name) {
     printf("Usage: %s [OPTIONS]\n\n", prog_name);
     printf("  -f, --fcfs           Use First Come First Served scheduling\n");
     printf("  -s, --sjf            Use Shortest Job First scheduling\n");
+    printf("  -t, --srtf           Use Shortest Remaining Time First (preemptive SJF)\n");
     printf("  -r, --rr             Use Round Robin scheduling (requires --quantum)\n");
     printf("  -p, --priority       Use Priority scheduling\n");
-    printf("  -i, --input <file>   Input CSV workload file\n");
+    printf("  -A, --aging <ticks>  Priority: a waiting process gains one priority level per n ticks\n");
+    printf("  -m, --mlfq           Use Multilevel Feedback Queue scheduling\n");
+    printf("  -C, --cfs            Use Completely Fair Scheduling (priority is the nice value)\n");
+    printf("  -l, --latency <n>    CFS target latency in ticks (default 24)\n");
+    printf("  -g, --min-gran <n>   CFS minimum slice in ticks (default 3)\n");
+    printf("  -P, --policy <name>  Use a registered policy by name:");
+    for (int k = 0; k < policy_count(); ++k) printf(" %s", policy_at(k)->name);
+    printf("\n");
+    printf("  -i, --input <file>   Input workload: CSV, or a binary trace from csv2bin\n");
     printf("  -q, --quantum <n>    Time quantum for Round Robin\n");
+    printf("  -L, --levels <n>     MLFQ levels (default 3, at most %d)\n", MLFQ_MAX_LEVELS);
+    printf("  -T, --level-quanta <q0,q1,...>\n");
+    printf("                       MLFQ quantum per level (default: --quantum or 2, doubling per level)\n");
+    printf("  -O, --boost <ticks>  MLFQ: move every process back to the top level this often\n");
+    printf("                       (default 100, 0 = never)\n");
+    printf("  -Q, --quantum-range <lo:hi:step>\n");
+    printf("                       RR sweep: one summary row per quantum in the range\n");
+    printf("  -e, --engine <name>  Engine: threaded (default), inline or event\n");
+    printf("  -w, --workers <n>    Threaded engine: worker threads running process bodies\n");
+    printf("                       (default: one per core)\n");
+    printf("  -S, --stream         Stream a CSV input: bounded memory, rows printed as jobs finish\n");
+    printf("                       (always the event engine)\n");
+    printf("  -W, --reorder-window <n>\n");
+    printf("                       With --stream, rows may be up to n lines out of arrival order\n");
+    printf("  -c, --cpus <n>       Simulate n CPUs (event-driven SMP engine, one Gantt lane per CPU;\n");
+    printf("                       --engine other than event is rejected)\n");
+    printf("  -R, --rq <policy>    With --cpus: percpu (default) or global ready queue\n");
+    printf("  -B, --balance <mode> With --rq percpu: idle (default), periodic[:ticks] or none\n");
+    printf("  -b, --batch <file>   Run every 'input,algorithm[,quantum]' job in a manifest\n");
+    printf("  -j, --jobs <n>       Batch/sweep worker threads (default: one per core)\n");
+    printf("      --output <fmt>   Report format: text (default), json, csv or bin\n");
+    printf("      --out-file <file>\n");
+    printf("                       Write the report to a file instead of stdout\n");
+    printf("      --quiet-gantt    Leave the timeline out of the report\n");
+    printf("      --summary-only   Report only the summary: no timeline, no per-process rows\n");
+    printf("      --stats          Add engine counters (dispatches, preemptions, queue depth, ...)\n");
+    printf("                       and the time spent per scheduler phase to the report\n");
+    printf("      --verify         Run the workload through the threaded, inline, event and 1-CPU SMP\n");
+    printf("                       engines and report where their schedules or metrics differ\n");
+    printf("      --fuzz <n>[:seed]\n");
+    printf("                       With --verify: n generated workloads instead of -i, every policy\n");
+    printf("                       unless one is given\n");
     printf("  -h, --help           Show this help message\n\n");
 }
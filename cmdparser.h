@@ -3,20 +3,69 @@
 
 #include <stdbool.h>
 
-// Enumeration for supported scheduling algorithms
+// Scheduling policy, from the registry in policy.c (see scheduler_wiring.h)
+struct policy_ops;
+
+#define MLFQ_MAX_LEVELS 8
+
+// Simulation engine used to run the chosen algorithm
 typedef enum {
-    SCHED_NONE,
-    SCHED_FCFS,
-    SCHED_SJF,
-    SCHED_RR,
-    SCHED_PRIORITY
-} scheduler_t;
+    ENGINE_THREADED,   // process bodies on a bounded worker pool, one slice per handoff
+    ENGINE_INLINE,     // same tick loop, single-threaded, no gates
+    ENGINE_EVENT       // single-threaded, jumps between scheduling events
+} engine_t;
+
+// Ready-queue layout when simulating more than one CPU (--rq)
+typedef enum {
+    RQ_POLICY_PERCPU,  // one queue per CPU, arrivals go to the least loaded CPU
+    RQ_POLICY_GLOBAL   // one queue shared by all CPUs
+} rq_policy_t;
+
+// Migration between per-CPU queues (--balance)
+typedef enum {
+    BALANCE_NONE,
+    BALANCE_IDLE,      // a CPU with nothing queued steals from the longest queue
+    BALANCE_PERIODIC   // every balance_interval ticks, even out queue lengths
+} balance_t;
+
+// Report format (--output)
+typedef enum {
+    OUTPUT_TEXT,       // human-readable tables
+    OUTPUT_JSON,
+    OUTPUT_CSV,
+    OUTPUT_BIN         // record stream, see report.h
+} output_fmt_t;
 
 // Structure holding parsed command-line options
 typedef struct {
-    scheduler_t scheduler;
+    const struct policy_ops *policy;   // NULL if none was given
     char input_file[256];
     int quantum;
+    engine_t engine;
+    char batch_file[256];   // --batch: manifest of (input, algorithm, quantum) jobs
+    int jobs;               // --jobs: batch/sweep worker threads (0 = one per core)
+    int workers;            // --workers: threaded engine pool size (0 = one per core)
+    int q_lo, q_hi, q_step; // --quantum-range lo:hi:step (RR sweep), q_step 0 = off
+    bool stream;            // --stream: bounded-memory streaming input
+    int reorder_window;     // --reorder-window: max rows an arrival may be late
+    int cpus;               // --cpus: simulated CPUs (> 1 uses the SMP engine)
+    rq_policy_t rq_policy;  // --rq
+    balance_t balance;      // --balance
+    int balance_interval;   // --balance periodic:<ticks>
+    int mlfq_levels;        // --levels (0 = default)
+    int mlfq_quanta[MLFQ_MAX_LEVELS];   // --level-quanta, 0 = derive from --quantum
+    int mlfq_boost;         // --boost ticks, -1 = default, 0 = off
+    int aging;              // --aging: PRIORITY ticks per priority step, 0 = off
+    int cfs_latency;        // --latency (0 = default)
+    int cfs_min_gran;       // --min-gran (0 = default)
+    output_fmt_t output;    // --output
+    char out_file[256];     // --out-file, empty = stdout
+    bool quiet_gantt;       // --quiet-gantt: no timeline
+    bool summary_only;      // --summary-only: no timeline, no per-process rows
+    bool stats;             // --stats: engine counters and phase timings (stats.h)
+    bool verify;            // --verify: cross-check the engines instead of reporting (verify.h)
+    int fuzz;               // --fuzz n[:seed]: with --verify, n generated workloads, 0 = off
+    unsigned long long fuzz_seed;
     bool show_help;
 } cmd_options_t;
 
@@ -24,4 +73,9 @@ typedef struct {
 cmd_options_t parse_arguments(int argc, char *argv[]);
 void print_usage(const char *prog_name);
 
+// Policy parameters (scheduler_wiring.h) from the options, as if quantum had
+// been passed with --quantum: a batch job's own quantum replaces the CLI one
+struct sched_params;
+void options_sched_params(const cmd_options_t *opts, int quantum, struct sched_params *sp);
+
 #endif
\ No newline at end of file
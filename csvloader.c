@@ -1,63 +1,167 @@
 // csv_loader.c — simple loader for: pid,arrival,burst,priority
+//
+// load_csv maps the file and parses it in one pass: newlines are located 16
+// bytes at a time (SSE2 on x86-64, NEON on arm64, memchr elsewhere), fields
+// are split and integers parsed by hand instead of through sscanf. Accepted
+// input and error messages are the same as the old fgets + sscanf loader.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "scheduler_wiring.h"   // for proc_t
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "csvloader.h"
 
-static void trim(char *s) {
-    size_t n = strlen(s);
-    while (n && (s[n-1]=='\n' || s[n-1]=='\r' || s[n-1]==' ' || s[n-1]=='\t')) s[--n] = 0;
-    while (*s && (*s==' ' || *s=='\t')) memmove(s, s+1, strlen(s));
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// First '\n' in [p, end), or end
+static const char *find_newline(const char *p, const char *end) {
+#if defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        int m = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), nl));
+        if (m) return p + __builtin_ctz((unsigned)m);
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t nl = vdupq_n_u8('\n');
+    for (; end - p >= 16; p += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8((const uint8_t*)p), nl);
+        uint64_t m = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (m) return p + (__builtin_ctzll(m) >> 2);
+    }
+#endif
+    const char *q = (end > p) ? (const char*)memchr(p, '\n', (size_t)(end - p)) : NULL;
+    return q ? q : end;
 }
 
-int load_csv(const char *path, proc_t **out_procs, int *out_nprocs) {
-    FILE *f = fopen(path, "r");
-    if (!f) { perror("fopen"); return -1; }
+static inline int is_ws(char c) {
+    return c==' ' || c=='\t' || c=='\n' || c=='\r' || c=='\v' || c=='\f';
+}
 
-    char line[256]; int cnt=0;
-    while (fgets(line, sizeof line, f)) {
-        trim(line);
-        if (line[0]=='#' || (int)strlen(line)<3) continue;
-        cnt++;
-    }
-    if (cnt == 0) {
-        fclose(f);
-        *out_procs = NULL; *out_nprocs = 0;
-        return 0;
+// Trim [*b, *e) the way the old trim() did: trailing \n \r space tab, leading space tab
+static inline void trim_span(const char **b, const char **e) {
+    while (*e > *b && ((*e)[-1]=='\n' || (*e)[-1]=='\r' || (*e)[-1]==' ' || (*e)[-1]=='\t')) (*e)--;
+    while (*b < *e && (**b==' ' || **b=='\t')) (*b)++;
+}
+
+// scanf-style %d: optional whitespace, sign, at least one digit
+static inline const char *parse_int(const char *p, const char *e, int *out) {
+    while (p < e && is_ws(*p)) p++;
+    int neg = 0;
+    if (p < e && (*p=='-' || *p=='+')) { neg = (*p=='-'); p++; }
+    if (p >= e || (unsigned)(*p - '0') > 9) return NULL;
+    long v = 0;
+    while (p < e && (unsigned)(*p - '0') <= 9) {
+        if (v < 0x7fffffffL) v = v * 10 + (*p - '0');
+        p++;
     }
+    if (v > 0x7fffffffL) v = 0x7fffffffL;
+    *out = (int)(neg ? -v : v);
+    return p;
+}
+
+static inline const char *expect_comma(const char *p, const char *e) {
+    while (p < e && is_ws(*p)) p++;
+    return (p < e && *p == ',') ? p + 1 : NULL;
+}
 
-    rewind(f);
-    proc_t *A = (proc_t*)calloc(cnt, sizeof(proc_t));
-    if (!A) { fclose(f); return -1; }
+// Parse a trimmed, non-comment row: 1 = ok, -1 = malformed. The pid is
+// [b, b + out->pid_len); it is not copied.
+// Same grammar as " %31[^,] , %d , %d , %d" (trailing text is ignored).
+static int parse_fields(const char *b, const char *e, csv_row_t *out) {
+    const char *c = (const char*)memchr(b, ',', (size_t)(e - b));
+    size_t plen = (size_t)((c ? c : e) - b);
+    if (plen == 0 || plen > 31) return -1;
+    out->pid_len = (int)plen;
 
-    int i = 0;
-    while (fgets(line, sizeof line, f)) {
-        trim(line);
-        if (line[0]=='#' || (int)strlen(line)<3) continue;
+    const char *p = b + plen;
+    if (!(p = expect_comma(p, e)) || !(p = parse_int(p, e, &out->arrival))) return -1;
+    if (!(p = expect_comma(p, e)) || !(p = parse_int(p, e, &out->burst)))   return -1;
+    if (!(p = expect_comma(p, e)) || !(p = parse_int(p, e, &out->priority))) return -1;
+    return 1;
+}
 
-        char pid[32]; int arr, bur, prio;
-        if (sscanf(line, " %31[^,] , %d , %d , %d", pid, &arr, &bur, &prio) != 4) {
-            fprintf(stderr, "Bad CSV row: %s\n", line);
-            free(A); fclose(f); return -1;
+// Parse one line in place: 1 = row stored in *out (pid/arrival/burst/priority),
+// 0 = comment or blank, -1 = malformed (line is left trimmed for the message)
+int csv_parse_row(char *line, csv_row_t *out) {
+    const char *b = line, *e = line + strlen(line);
+    trim_span(&b, &e);
+    size_t n = (size_t)(e - b);
+    memmove(line, b, n);
+    line[n] = 0;
+    if (line[0]=='#' || n<3) return 0;
+    int rc = parse_fields(line, line + n, out);
+    if (rc > 0) {
+        memcpy(out->pid, line, (size_t)out->pid_len);
+        out->pid[out->pid_len] = 0;
+    }
+    return rc;
+}
+
+// Whole file in memory: mmap for regular files, read() loop otherwise (pipes)
+static char *map_input(int fd, size_t *out_len, int *out_mapped) {
+    struct stat st;
+    *out_mapped = 0;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        *out_len = (size_t)st.st_size;
+        if (st.st_size == 0) return NULL;
+        void *m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m != MAP_FAILED) {
+            madvise(m, (size_t)st.st_size, MADV_SEQUENTIAL);
+            *out_mapped = 1;
+            return (char*)m;
         }
+    }
+    size_t cap = 1 << 16, len = 0;
+    char *buf = (char*)malloc(cap);
+    for (;;) {
+        if (len == cap) buf = (char*)realloc(buf, cap *= 2);
+        ssize_t r = read(fd, buf + len, cap - len);
+        if (r <= 0) break;
+        len += (size_t)r;
+    }
+    *out_len = len;
+    return buf;
+}
+
+int load_csv(const char *path, proc_table_t *out) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { perror("fopen"); return -1; }
 
-        snprintf(A[i].pid, sizeof(A[i].pid), "%s", pid);
-        A[i].arrival = arr;
-        A[i].burst   = bur;
-        A[i].priority= prio;
-
-        A[i].remaining     = bur;
-        A[i].started_time  = -1;
-        A[i].finish_time   = -1;
-        A[i].response_time = -1;
-        A[i].waiting_time  = 0;
-        A[i].admitted      = false;
-        A[i].done          = false;
-        i++;
+    size_t len; int mapped;
+    char *data = map_input(fd, &len, &mapped);
+    close(fd);
+
+    proc_table_t T;
+    pt_init(&T);
+    int rc = 0;
+    const char *p = data, *end = data + len;
+    while (p < end) {
+        const char *nl = find_newline(p, end);
+        const char *b = p, *e = nl;
+        p = (nl < end) ? nl + 1 : end;
+
+        trim_span(&b, &e);
+        if (e - b < 3 || *b=='#') continue;
+
+        csv_row_t r;
+        if (parse_fields(b, e, &r) < 0) {
+            fprintf(stderr, "Bad CSV row: %.*s\n", (int)(e - b), b);
+            rc = -1;
+            break;
+        }
+        pt_append(&T, b, r.pid_len, r.arrival, r.burst, r.priority);
     }
-    fclose(f);
 
-    *out_procs = A;
-    *out_nprocs = cnt;
-    return 0;
+    if (mapped) munmap(data, len);
+    else free(data);
+
+    if (rc != 0) pt_free(&T);
+    *out = T;
+    return rc;
 }
\ No newline at end of file
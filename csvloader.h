@@ -0,0 +1,20 @@
+#ifndef CSVLOADER_H
+#define CSVLOADER_H
+
+#include "scheduler_wiring.h"   // proc_table_t
+
+// One parsed row, for callers that consume rows one at a time (stream.c)
+typedef struct {
+    char pid[32];
+    int  pid_len;
+    int  arrival, burst, priority;
+} csv_row_t;
+
+// Load "pid,arrival,burst,priority" rows ('#' lines are comments) into *out
+// (owned by the caller, release with pt_free). Call pt_reset before a run.
+int  load_csv(const char *path, proc_table_t *out);
+
+// Parse one CSV line in place: 1 = row, 0 = comment/blank, -1 = malformed
+int  csv_parse_row(char *line, csv_row_t *out);
+
+#endif
@@ -1,27 +1,32 @@
 // main.c — minimal driver using your CLI + our scheduler wiring
 #include <stdio.h>
 #include <stdlib.h>
-#include "cmdparser.h"         // your CLI: parse_arguments, print_usage, scheduler_t
-#include "scheduler_wiring.h"  // run_scheduler(...) + proc_t typedef
+#include "cmdparser.h"         // your CLI: parse_arguments, print_usage
+#include "scheduler_wiring.h"  // run_scheduler(...) + proc_table_t
 #include "metrics.h"
+#include "stats.h"
+#include "trace.h"             // load_workload (CSV or binary trace)
+#include "batch.h"
+#include "rr_sweep.h"
+#include "stream.h"
+#include "report.h"
+#include "verify.h"
 #include <string.h>
 
-// If you already have a CSV loader, declare it here and link it.
-// Expected signature:
-int load_csv(const char *path, proc_t **out_procs, int *out_nprocs);
-
-// Initialize fields expected by the scheduler core
-static void init_proc_fields(proc_t *procs, int n) {
-    for (int i = 0; i < n; ++i) {
-        procs[i].remaining     = procs[i].burst;
-        procs[i].started_time  = -1;
-        procs[i].finish_time   = -1;
-        procs[i].response_time = 0;
-        procs[i].waiting_time  = 0;
-        procs[i].admitted      = false;
-        procs[i].done          = false;
-        // run_sem is initialized in proc_sems_init() inside scheduler_wiring.c
-    }
+// Report destination and contents from --output, --out-file, --quiet-gantt, --summary-only
+static report_t *open_report(const cmd_options_t *opts) {
+    return report_open(opts->output, opts->out_file[0] ? opts->out_file : NULL,
+                       !opts->quiet_gantt && !opts->summary_only, !opts->summary_only);
+}
+
+// Rows (if wanted), summary and --stats, then close; returns the exit status
+static int finish_report(report_t *rep, const proc_table_t *procs, const metrics_t *M, int makespan,
+                         const sched_stats_t *stats) {
+    report_rows(rep, procs);
+    int w = M->max_wait_proc;
+    report_summary(rep, M, makespan, w >= 0 ? pt_pid(procs, w) : NULL, w >= 0 ? pt_pid_len(procs, w) : 0, -1);
+    if (stats) report_stats(rep, stats);
+    return report_close(rep) == 0 ? 0 : 1;
 }
 
 int main(int argc, char **argv) {
@@ -32,38 +37,104 @@ int main(int argc, char **argv) {
         return 0;
     }
 
+    // Policy parameters: defaults derived from the quantum, then MLFQ / aging / CFS overrides
+    sched_params_t sp;
+    options_sched_params(&opts, opts.quantum, &sp);
+
+    // Batch mode: many (input, algorithm, quantum) jobs across all cores,
+    // each with the CLI's policy parameters and its own quantum
+    if (strlen(opts.batch_file) > 0)
+        return run_batch(&opts);
+
+    // Differential check of the engines, on the input or on generated workloads
+    if (opts.verify)
+        return opts.fuzz > 0 ? run_verify_fuzz(opts.fuzz, opts.fuzz_seed, opts.policy, opts.workers)
+                             : run_verify(opts.input_file, opts.policy, &sp, opts.workers);
+
+    // Streaming: never holds the whole trace in memory
+    if (opts.stream) {
+        report_t *rep = open_report(&opts);
+        if (!rep) return 1;
+        int rc = run_stream(opts.input_file, opts.policy, &sp, opts.reorder_window, rep);
+        return (report_close(rep) == 0) ? rc : 1;
+    }
+
+    // RR quantum sweep: one load, every quantum in the range
+    if (opts.q_step > 0)
+        return run_rr_sweep(opts.input_file, opts.q_lo, opts.q_hi, opts.q_step, opts.jobs);
+
     // 2) Load processes (pid, arrival, burst, priority) -> procs[], nprocs
-    proc_t *procs = NULL; 
-    int nprocs = 0;
-    if (load_csv(opts.input_file, &procs, &nprocs) != 0) {
+    proc_table_t procs;
+    if (load_workload(opts.input_file, &procs) != 0) {
         fprintf(stderr, "Failed to load input: %s\n", opts.input_file);
         return 1;
     }
-    if (nprocs == 0) {
+    if (procs.n == 0) {
         fprintf(stderr, "No processes found in %s\n", opts.input_file);
-        free(procs);
+        pt_free(&procs);
         return 1;
     }
 
-    init_proc_fields(procs, nprocs);
+    pt_reset(&procs);
+
+    // Opened before the run, so a bad --out-file fails before simulating
+    report_t *rep = open_report(&opts);
+    if (!rep) {
+        pt_free(&procs);
+        return 1;
+    }
+
+    sched_stats_t stats_buf;
+    sched_stats_t *stats = opts.stats ? &stats_buf : NULL;
+
+    // SMP: one lane and one ready queue (or a shared one) per simulated CPU
+    if (opts.cpus > 1) {
+        smp_config_t cfg = { opts.cpus, opts.rq_policy, opts.balance, opts.balance_interval };
+        cpu_stats_t *cpus = (cpu_stats_t*)calloc(opts.cpus, sizeof(cpu_stats_t));
+        metrics_acc_t acc;
+        macc_init(&acc);
+        int makespan = run_scheduler_smp(&procs, opts.policy, &sp, &acc, stats, &cfg, cpus,
+                                         report_wants_timeline(rep));
+
+        report_info_t info = { opts.policy->label, opts.cpus,
+                               opts.rq_policy == RQ_POLICY_GLOBAL ? "global" : "per-CPU",
+                               false, makespan, procs.n };
+        report_begin(rep, &info);
+        for (int c = 0; c < opts.cpus; ++c) report_timeline(rep, c, cpus[c].segs, cpus[c].nsegs, &procs);
+        metrics_t M = compute_metrics_smp(&acc, makespan, cpus, opts.cpus);
+        int rc = finish_report(rep, &procs, &M, makespan, stats);
+
+        metrics_free(&M);
+        for (int c = 0; c < opts.cpus; ++c) free(cpus[c].segs);
+        free(cpus);
+        pt_free(&procs);
+        return rc;
+    }
 
-    // 3) Run the scheduler loop (spawns threads, uses semaphores, returns makespan/timeline)
-    int *timeline = NULL, tl_len = 0;
-    int makespan = run_scheduler(procs, nprocs, opts.scheduler, opts.quantum, &timeline, &tl_len);
+    // 3) Run the scheduler loop (worker pool, slice handoffs, returns makespan/timeline)
+    //    or the event-driven engine (single thread); all return an RLE timeline,
+    //    unless the report leaves it out
+    tl_seg_t *segs = NULL; int nsegs = 0;
+    tl_seg_t **want_segs = report_wants_timeline(rep) ? &segs : NULL;
+    metrics_acc_t acc;
+    macc_init(&acc);
+    int makespan;
+    if (opts.engine == ENGINE_EVENT)
+        makespan = run_scheduler_events(&procs, opts.policy, &sp, &acc, stats, want_segs, &nsegs);
+    else if (opts.engine == ENGINE_INLINE)
+        makespan = run_scheduler_inline(&procs, opts.policy, &sp, &acc, stats, want_segs, &nsegs);
+    else
+        makespan = run_scheduler(&procs, opts.policy, &sp, opts.workers, &acc, stats, want_segs, &nsegs);
 
     // 4) Metrics & output
-    const char *algname =
-        (opts.scheduler == SCHED_FCFS)     ? "FCFS" :
-        (opts.scheduler == SCHED_SJF)      ? "SJF" :
-        (opts.scheduler == SCHED_RR)       ? "RR" :
-        (opts.scheduler == SCHED_PRIORITY) ? "PRIORITY" : "UNKNOWN";
-    printf("\n===== %s Scheduling =====\n", algname);
-    printf("Finished in %d ticks. Processes: %d\n", makespan, nprocs);
-
-    (void)compute_and_print_metrics(procs, nprocs, makespan, timeline, tl_len);
+    report_info_t info = { opts.policy->label, 1, NULL, false, makespan, procs.n };
+    report_begin(rep, &info);
+    report_timeline(rep, 0, segs, nsegs, &procs);
+    metrics_t M = metrics_from_acc(&acc, makespan, 1);
+    int rc = finish_report(rep, &procs, &M, makespan, stats);
     
     // 5) Cleanup
-    free(timeline);
-    free(procs);
-    return 0;
+    free(segs);
+    pt_free(&procs);
+    return rc;
 }
\ No newline at end of file
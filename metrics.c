@@ -1,84 +1,155 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <math.h>
 #include "metrics.h"
 
-static void print_gantt(const int *tl, int n, proc_t *procs) {
-    if (!tl || n <= 0) return;
-
-    // Compress consecutive slots into segments [start,end) of the same proc
-    printf("\nTimeline (Gantt):\n");
-    int start = 0, cur = tl[0];
-    for (int t = 1; t <= n; ++t) {
-        if (t == n || tl[t] != cur) {
-            // print segment [start, t) labeled by PID or IDLE
-            if (cur < 0) {
-                printf("[%4d..%4d): IDLE\n", start, t);
-            } else {
-                printf("[%4d..%4d): %s\n", start, t, procs[cur].pid);
-            }
-            if (t < n) { start = t; cur = tl[t]; }
-        }
-    }
-    puts("");
+// ---- streaming distributions ----
+
+static int dist_bucket(int v) {
+    if (v < DIST_SUB) return v < 0 ? 0 : v;
+    int h = 31 - __builtin_clz((unsigned)v);   // v >= DIST_SUB, so h >= DIST_SUB_BITS
+    return DIST_SUB * (h - DIST_SUB_BITS + 1) + ((v >> (h - DIST_SUB_BITS)) & (DIST_SUB - 1));
 }
 
-metrics_t compute_and_print_metrics(proc_t *procs, int nprocs, int makespan, const int *timeline, int tl_len) {
-    metrics_t M = {0};
-    long sum_wait = 0, sum_resp = 0, sum_turn = 0;
-
-    // CPU busy ticks from timeline (if present), else infer from bursts
-    long cpu_busy = 0;
-    if (timeline && tl_len > 0) {
-        for (int i = 0; i < tl_len; ++i) {
-            if (timeline[i] >= 0){
-                cpu_busy++;
-            }
-        }
-    } else {
-        // fallback: sum original bursts
-        for (int i = 0; i < nprocs; ++i){
-            cpu_busy += procs[i].burst;
+// Largest value that lands in bucket b
+static int dist_bucket_top(int b) {
+    if (b < DIST_SUB) return b;
+    int shift = b / DIST_SUB - 1;
+    long long low = (long long)(DIST_SUB + b % DIST_SUB) << shift;
+    long long top = low + (1LL << shift) - 1;
+    return top > INT_MAX ? INT_MAX : (int)top;
+}
+
+void dist_init(dist_t *d) {
+    memset(d, 0, sizeof *d);
+}
+
+void dist_add(dist_t *d, int v) {
+    if (d->n == 0 || v < d->min) d->min = v;
+    if (d->n == 0 || v > d->max) d->max = v;
+    d->n++;
+    d->sum += v;
+    double delta = v - d->mean;
+    d->mean += delta / (double)d->n;
+    d->m2 += delta * (v - d->mean);
+    d->count[dist_bucket(v)]++;
+}
+
+// Chan et al.'s pairwise update for the mean and sum of squares
+void dist_merge(dist_t *into, const dist_t *from) {
+    if (from->n == 0) return;
+    if (into->n == 0) { *into = *from; return; }
+    long long n = into->n + from->n;
+    double delta = from->mean - into->mean;
+    into->m2 += from->m2 + delta * delta * ((double)into->n * (double)from->n / (double)n);
+    into->mean += delta * ((double)from->n / (double)n);
+    into->n = n;
+    into->sum += from->sum;
+    if (from->min < into->min) into->min = from->min;
+    if (from->max > into->max) into->max = from->max;
+    for (int b = 0; b < DIST_BUCKETS; ++b) into->count[b] += from->count[b];
+}
+
+// Nearest-rank quantile, reported as the top of its bucket (never past max)
+int dist_quantile(const dist_t *d, double q) {
+    if (d->n == 0) return 0;
+    if (q <= 0) return d->min;
+    long long rank = (long long)ceil(q * (double)d->n);
+    if (rank < 1) rank = 1;
+    if (rank >= d->n) return d->max;
+    long long seen = 0;
+    for (int b = 0; b < DIST_BUCKETS; ++b) {
+        seen += d->count[b];
+        if (seen >= rank) {
+            int v = dist_bucket_top(b);
+            if (v > d->max) v = d->max;
+            if (v < d->min) v = d->min;
+            return v;
         }
     }
+    return d->max;
+}
 
-    // Gantt
-    print_gantt(timeline, tl_len, procs);
-
-    // Table header
-    printf("-------------------------------------\n");
-    printf("PID       Arr  Burst  Start  Finish  Wait  Resp  Turn\n");
-
-    for (int i = 0; i < nprocs; ++i) {
-        int turn = procs[i].finish_time - procs[i].arrival;
-        sum_wait += procs[i].waiting_time;
-        sum_resp += procs[i].response_time;
-        sum_turn += turn;
-
-        printf("%-8s %4d  %5d  %5d  %6d  %4d  %4d  %4d\n",
-               procs[i].pid,
-               procs[i].arrival,
-               procs[i].burst,
-               procs[i].started_time,
-               procs[i].finish_time,
-               procs[i].waiting_time,
-               procs[i].response_time,
-               turn);
-    }
-    printf("-------------------------------------\n");
+double dist_stddev(const dist_t *d) {
+    return d->n > 1 ? sqrt(d->m2 / (double)d->n) : 0.0;
+}
 
-    // Globals
-    M.avg_wait = (double)sum_wait / nprocs;
-    M.avg_resp = (double)sum_resp / nprocs;
-    M.avg_turn = (double)sum_turn / nprocs;
-    M.throughput = (makespan > 0) ? ((double)nprocs / (double)makespan) : 0.0;
-    M.cpu_utilization = (makespan > 0) ? (100.0 * (double)cpu_busy / (double)makespan) : 0.0;
+// ---- run accumulator ----
 
-    printf("Avg Wait = %.2f\n", M.avg_wait);
-    printf("Avg Resp = %.2f\n", M.avg_resp);
-    printf("Avg Turn = %.2f\n", M.avg_turn);
-    printf("Throughput = %.3f jobs/unit time\n", M.throughput);
-    printf("CPU Utilization = %.1f%%\n", M.cpu_utilization);
+void macc_init(metrics_acc_t *a) {
+    dist_init(&a->wait);
+    dist_init(&a->resp);
+    dist_init(&a->turn);
+    a->busy = 0;
+    a->max_wait_proc = -1;
+}
+
+void macc_complete(metrics_acc_t *a, const proc_table_t *procs, int i) {
+    int wait = procs->waiting_time[i];
+    if (a->max_wait_proc < 0 || wait > a->wait.max || (wait == a->wait.max && i < a->max_wait_proc))
+        a->max_wait_proc = i;
+    dist_add(&a->wait, wait);
+    dist_add(&a->resp, procs->response_time[i]);
+    dist_add(&a->turn, procs->finish_time[i] - procs->arrival[i]);
+    a->busy += procs->burst[i] - procs->remaining[i];   // remaining can overshoot below 0
+}
+
+void macc_merge(metrics_acc_t *into, const metrics_acc_t *from) {
+    dist_merge(&into->wait, &from->wait);
+    dist_merge(&into->resp, &from->resp);
+    dist_merge(&into->turn, &from->turn);
+    into->busy += from->busy;
+    into->max_wait_proc = -1;   // indices of different runs don't compare
+}
+
+static dist_summary_t summarize(const dist_t *d) {
+    dist_summary_t s = {0};
+    if (d->n == 0) return s;
+    s.mean   = (double)d->sum / (double)d->n;
+    s.stddev = dist_stddev(d);
+    s.p50    = dist_quantile(d, 0.50);
+    s.p95    = dist_quantile(d, 0.95);
+    s.p99    = dist_quantile(d, 0.99);
+    s.max    = d->max;
+    return s;
+}
 
+// Global metrics only, nothing printed
+metrics_t metrics_from_acc(const metrics_acc_t *a, int makespan, int ncpus) {
+    metrics_t M = {0};
+    M.nprocs = a->wait.n;
+    M.wait = summarize(&a->wait);
+    M.resp = summarize(&a->resp);
+    M.turn = summarize(&a->turn);
+    M.avg_wait = M.wait.mean;
+    M.avg_resp = M.resp.mean;
+    M.avg_turn = M.turn.mean;
+    M.max_wait = M.wait.max;
+    M.max_wait_proc = M.nprocs > 0 ? a->max_wait_proc : -1;
+    M.ncpus = ncpus > 0 ? ncpus : 1;
+    M.throughput = (makespan > 0) ? ((double)M.nprocs / (double)makespan) : 0.0;
+    M.cpu_utilization = (makespan > 0) ? (100.0 * (double)a->busy / (double)makespan / M.ncpus) : 0.0;
     return M;
-}
\ No newline at end of file
+}
+
+metrics_t compute_metrics_smp(const metrics_acc_t *acc, int makespan, const cpu_stats_t *cpus, int ncpus) {
+    metrics_t M = metrics_from_acc(acc, makespan, ncpus);
+    M.cores = (core_metrics_t*)calloc(ncpus, sizeof(core_metrics_t));
+    for (int c = 0; c < ncpus; ++c) {
+        core_metrics_t *K = &M.cores[c];
+        K->busy        = cpus[c].busy;
+        K->utilization = (makespan > 0) ? (100.0 * (double)cpus[c].busy / (double)makespan) : 0.0;
+        K->dispatches  = cpus[c].dispatches;
+        K->migrations  = cpus[c].migrations;
+        K->steals      = cpus[c].steals;
+        M.migrations  += cpus[c].migrations;
+    }
+    return M;
+}
+
+void metrics_free(metrics_t *m) {
+    free(m->cores);
+    m->cores = NULL;
+}
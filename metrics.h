@@ -3,14 +3,77 @@
 
 #include "scheduler_wiring.h"
 
+// Per-core breakdown of an SMP run
+typedef struct {
+    long   busy;             // ticks
+    double utilization;      // busy / makespan, %
+    long   dispatches, migrations, steals;
+} core_metrics_t;
+
+// Streaming distribution of int samples: count, exact sum (so means are
+// exact), min, max, variance by Welford's update, and a log-bucketed
+// histogram for quantiles. Values below DIST_SUB are exact; above, each
+// power of two is split into DIST_SUB buckets, so a quantile is within
+// 1/DIST_SUB (< 1%) of the true sample. Fixed size, no allocation, and two
+// distributions merge by adding buckets, so parallel runs combine exactly
+// as if their samples had gone into one.
+#define DIST_SUB_BITS 7
+#define DIST_SUB      (1 << DIST_SUB_BITS)
+#define DIST_BUCKETS  (DIST_SUB * (32 - DIST_SUB_BITS))
+
+typedef struct {
+    long long n, sum;
+    int       min, max;
+    double    mean, m2;              // Welford running mean and sum of squares
+    long long count[DIST_BUCKETS];   // negative samples count in bucket 0
+} dist_t;
+
+void   dist_init(dist_t *d);
+void   dist_add(dist_t *d, int v);
+void   dist_merge(dist_t *into, const dist_t *from);
+int    dist_quantile(const dist_t *d, double q);   // 0 <= q <= 1; 0 if empty
+double dist_stddev(const dist_t *d);
+
+// Online run metrics, fed one completion at a time by the engines
+// (macc_complete), so a run's summary needs no pass over the process table
+// and accumulators from separate runs merge.
+struct metrics_acc {
+    dist_t wait, resp, turn;
+    long   busy;            // CPU ticks consumed by completed procs
+    int    max_wait_proc;   // proc with the longest wait, lowest index on ties; -1 if none
+};
+
+void macc_init(metrics_acc_t *a);
+void macc_complete(metrics_acc_t *a, const proc_table_t *procs, int i);   // i just finished
+void macc_merge(metrics_acc_t *into, const metrics_acc_t *from);   // max_wait_proc becomes -1
+
+// Summary of one distribution
+typedef struct {
+    double mean, stddev;
+    int    p50, p95, p99, max;
+} dist_summary_t;
+
 // Holds global
 typedef struct {
     double avg_wait, avg_resp, avg_turn;
+    int    max_wait;         // longest total wait, the starvation indicator
+    int    max_wait_proc;    // proc that waited max_wait, -1 if none
     double throughput;       // jobs / tick
-    double cpu_utilization; 
+    double cpu_utilization;  // % of makespan x ncpus spent running procs
+    int    ncpus;            // 1 for the single-CPU engines
+    long   migrations;       // total over all cores
+    core_metrics_t *cores;   // ncpus entries for SMP runs, else NULL (metrics_free)
+    long long nprocs;
+    dist_summary_t wait, resp, turn;
 } metrics_t;
 
 
-metrics_t compute_and_print_metrics(proc_t *procs, int nprocs, int makespan, const int *timeline, int tl_len);
+// Summary from an accumulator; makespan and ncpus scale throughput and utilisation.
+// Printing is report.h's job.
+metrics_t metrics_from_acc(const metrics_acc_t *a, int makespan, int ncpus);
+
+// SMP runs: per-core metrics from run_scheduler_smp's cpu_stats_t
+metrics_t compute_metrics_smp(const metrics_acc_t *acc, int makespan, const cpu_stats_t *cpus, int ncpus);
+void      metrics_free(metrics_t *m);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+// outbuf.c — chunked report writer
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "outbuf.h"
+
+void ob_init(outbuf_t *ob, FILE *f) {
+    ob->f = f;
+    ob->cap = OUTBUF_SIZE;
+    ob->buf = (char*)malloc(ob->cap);
+    ob->len = 0;
+    ob->err = false;
+}
+
+int ob_flush(outbuf_t *ob) {
+    if (ob->len > 0 && !ob->err && fwrite(ob->buf, 1, ob->len, ob->f) != ob->len) ob->err = true;
+    ob->len = 0;
+    if (!ob->err && fflush(ob->f) != 0) ob->err = true;
+    return ob->err ? -1 : 0;
+}
+
+int ob_close(outbuf_t *ob) {
+    int rc = ob_flush(ob);
+    free(ob->buf);
+    ob->buf = NULL;
+    ob->cap = 0;
+    return rc;
+}
+
+void ob_write(outbuf_t *ob, const char *s, size_t n) {
+    if (ob->cap - ob->len < n) {
+        ob_flush(ob);
+        if (n > ob->cap) {   // bigger than the whole buffer: straight through
+            if (!ob->err && fwrite(s, 1, n, ob->f) != n) ob->err = true;
+            return;
+        }
+    }
+    memcpy(ob->buf + ob->len, s, n);
+    ob->len += n;
+}
+
+void ob_puts(outbuf_t *ob, const char *s) {
+    ob_write(ob, s, strlen(s));
+}
+
+void ob_pad(outbuf_t *ob, char c, int n) {
+    for (; n > 0; --n) ob_putc(ob, c);
+}
+
+// Digits of v, most significant first, at the end of buf[24]; returns the start
+static char *fmt_int(char *end, long long v) {
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    char *p = end;
+    do { *--p = (char)('0' + u % 10); u /= 10; } while (u);
+    if (v < 0) *--p = '-';
+    return p;
+}
+
+void ob_int(outbuf_t *ob, long long v) {
+    char buf[24], *end = buf + sizeof buf;
+    char *p = fmt_int(end, v);
+    ob_write(ob, p, (size_t)(end - p));
+}
+
+void ob_int_w(outbuf_t *ob, long long v, int width) {
+    char buf[24], *end = buf + sizeof buf;
+    char *p = fmt_int(end, v);
+    ob_pad(ob, ' ', width - (int)(end - p));
+    ob_write(ob, p, (size_t)(end - p));
+}
+
+void ob_str_w(outbuf_t *ob, const char *s, size_t n, int width) {
+    ob_write(ob, s, n);
+    ob_pad(ob, ' ', width - (int)n);
+}
+
+// For the handful of summary lines with floating-point fields
+void ob_printf(outbuf_t *ob, const char *fmt, ...) {
+    char line[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof line, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    ob_write(ob, line, (size_t)n < sizeof line ? (size_t)n : sizeof line - 1);
+}
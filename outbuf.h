@@ -0,0 +1,39 @@
+#ifndef OUTBUF_H
+#define OUTBUF_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Buffered output for bulk reports. Rows are assembled in a large buffer
+// with hand-rolled integer formatting and handed to the FILE in big chunks,
+// so a million-row table costs a few fwrite calls instead of a printf per
+// row. Writing into the FILE keeps the order right when the same stream is
+// also used with printf elsewhere, as long as the outbuf is flushed first.
+#define OUTBUF_SIZE (1 << 20)
+
+typedef struct {
+    FILE  *f;
+    char  *buf;
+    size_t len, cap;
+    bool   err;        // a write failed; later output is dropped
+} outbuf_t;
+
+void ob_init(outbuf_t *ob, FILE *f);
+int  ob_flush(outbuf_t *ob);     // 0, or -1 if any write failed
+int  ob_close(outbuf_t *ob);     // flush and free the buffer (not the FILE)
+
+void ob_write(outbuf_t *ob, const char *s, size_t n);
+void ob_puts(outbuf_t *ob, const char *s);
+void ob_pad(outbuf_t *ob, char c, int n);
+void ob_int(outbuf_t *ob, long long v);
+void ob_int_w(outbuf_t *ob, long long v, int width);             // right-aligned, like %*d
+void ob_str_w(outbuf_t *ob, const char *s, size_t n, int width); // left-aligned, like %-*.*s
+void ob_printf(outbuf_t *ob, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static inline void ob_putc(outbuf_t *ob, char c) {
+    if (ob->len == ob->cap) ob_flush(ob);
+    ob->buf[ob->len++] = c;
+}
+
+#endif
@@ -0,0 +1,237 @@
+// policy.c — built-in scheduling policies and the policy registry.
+//
+// Each built-in is an ops table over the pick_next_* functions in
+// sched_core.c plus the policy's own queue backend and event slice, so the
+// engines reach every policy, built-in or registered, through the same calls.
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include "scheduler_wiring.h"
+
+void policy_init(policy_t *p, const policy_ops_t *ops, proc_table_t *procs, int nprocs,
+                 const sched_params_t *sp) {
+    memset(p, 0, sizeof *p);
+    p->ops = ops;
+    p->procs = procs;
+    p->sp = sp;
+    ops->init(p, nprocs);
+}
+
+void policy_destroy(policy_t *p) {
+    if (p->ops->destroy) p->ops->destroy(p);
+    rq_destroy(&p->rq);
+}
+
+/* Cap a slice at the next arrival, which could preempt */
+static int until_arrival(int slice, int next_arrival, int now) {
+    if (next_arrival != INT_MAX && next_arrival - now < slice) slice = next_arrival - now;
+    return slice;
+}
+
+static void spend_budget(policy_t *p, int running, int ticks, int *budget) {
+    (void)p; (void)running;
+    *budget -= ticks;
+}
+
+// ---- FCFS / SJF: non-preemptive, the dispatch runs to completion ----
+
+static void fifo_init(policy_t *p, int nprocs) { rq_init(&p->rq, nprocs); }
+
+static void remaining_init(policy_t *p, int nprocs) {
+    rq_init_heap(&p->rq, nprocs, p->procs, RQ_KEY_REMAINING);
+}
+
+static int whole_burst(policy_t *p, int chosen, int budget, int next_arrival, int now) {
+    (void)budget; (void)next_arrival; (void)now;
+    return p->procs->remaining[chosen];
+}
+
+static int fcfs_pick(policy_t *p, int running, int now, int *budget) {
+    (void)now; (void)budget;
+    return pick_next_fcfs(&p->rq, p->procs, running);
+}
+
+static int sjf_pick(policy_t *p, int running, int now, int *budget) {
+    (void)now; (void)budget;
+    return pick_next_sjf(&p->rq, p->procs, running);
+}
+
+// ---- SRTF: only an arrival can preempt ----
+
+static int srtf_pick(policy_t *p, int running, int now, int *budget) {
+    (void)now; (void)budget;
+    return pick_next_srtf(&p->rq, p->procs, running);
+}
+
+static int srtf_slice(policy_t *p, int chosen, int budget, int next_arrival, int now) {
+    (void)budget;
+    return until_arrival(p->procs->remaining[chosen], next_arrival, now);
+}
+
+// ---- RR ----
+
+static int rr_pick(policy_t *p, int running, int now, int *budget) {
+    (void)now;
+    return pick_next_rr(&p->rq, p->procs, running, budget, p->sp->quantum);
+}
+
+static int budget_slice(policy_t *p, int chosen, int budget, int next_arrival, int now) {
+    (void)next_arrival; (void)now;
+    int slice = p->procs->remaining[chosen];
+    return budget < slice ? budget : slice;
+}
+
+// ---- PRIORITY, optionally aged ----
+
+static void priority_init(policy_t *p, int nprocs) {
+    if (p->sp && p->sp->aging > 0) {
+        rq_init_heap(&p->rq, nprocs, p->procs, RQ_KEY_AGED);
+        p->rq.age_ticks = p->sp->aging;
+    } else {
+        rq_init_heap(&p->rq, nprocs, p->procs, RQ_KEY_PRIORITY);
+    }
+}
+
+static int priority_pick(policy_t *p, int running, int now, int *budget) {
+    (void)budget;
+    return pick_next_priority(&p->rq, p->procs, running, now);
+}
+
+/* The running proc is requeued at the tail each tick, so an equal priority
+   peer takes over on the very next tick; otherwise only a new arrival can
+   preempt it, or under aging the best waiter once the running proc's rank
+   (priority + now / aging) has caught up with it */
+static int priority_slice(policy_t *p, int chosen, int budget, int next_arrival, int now) {
+    (void)budget;
+    const proc_table_t *procs = p->procs;
+    int aging = p->sp->aging;
+    int best = rq_min_priority(&p->rq, procs);
+    int mine = procs->priority[chosen] + (aging > 0 ? now / aging : 0);
+    if (best <= mine) return 1;
+
+    int slice = until_arrival(procs->remaining[chosen], next_arrival, now);
+    if (aging > 0 && best != INT_MAX) {
+        long overtaken = (long)(best - procs->priority[chosen]) * aging;
+        if (overtaken - now < slice) slice = (int)(overtaken - now);
+    }
+    return slice;
+}
+
+// ---- MLFQ ----
+
+typedef struct {
+    int next_boost;   // tick of the next boost, INT_MAX if off
+} mlfq_state_t;
+
+static void mlfq_init(policy_t *p, int nprocs) {
+    rq_init_levels(&p->rq, nprocs, p->procs);
+    mlfq_state_t *st = (mlfq_state_t*)malloc(sizeof *st);
+    st->next_boost = mlfq_next_boost(p->sp, 0);
+    p->state = st;
+}
+
+static void mlfq_destroy(policy_t *p) {
+    free(p->state);
+    p->state = NULL;
+}
+
+static void mlfq_clock(policy_t *p, const int *running, int nrunning, int now) {
+    mlfq_state_t *st = (mlfq_state_t*)p->state;
+    if (now < st->next_boost) return;
+    mlfq_boost(&p->rq, p->procs, -1);
+    for (int k = 0; k < nrunning; ++k) p->procs->level[running[k]] = 0;
+    st->next_boost = mlfq_next_boost(p->sp, now);
+}
+
+static int mlfq_pick(policy_t *p, int running, int now, int *budget) {
+    (void)now;
+    return pick_next_mlfq(&p->rq, p->procs, running, budget, p->sp);
+}
+
+/* Quantum left; below the top level a new arrival preempts; a boost
+   reorders the queue, so it is a decision point too */
+static int mlfq_slice(policy_t *p, int chosen, int budget, int next_arrival, int now) {
+    int boost = mlfq_next_boost(p->sp, now);
+    int slice = p->procs->remaining[chosen];
+    if (budget < slice) slice = budget;
+    if (p->procs->level[chosen] > 0) slice = until_arrival(slice, next_arrival, now);
+    if (boost != INT_MAX && boost - now < slice) slice = boost - now;
+    return slice;
+}
+
+// ---- CFS: the slice, no wakeup preemption ----
+
+static void cfs_init(policy_t *p, int nprocs) { rq_init_tree(&p->rq, nprocs, p->procs); }
+
+static int cfs_pick(policy_t *p, int running, int now, int *budget) {
+    (void)now;
+    return pick_next_cfs(&p->rq, p->procs, running, budget, p->sp);
+}
+
+/* Fixed per-tick vruntime increment, so k one-tick charges equal one k-tick
+   charge and every engine ends up with the same vruntimes */
+static void cfs_tick(policy_t *p, int running, int ticks, int *budget) {
+    int64_t per_tick = ((int64_t)1024 << 16) / cfs_weight(p->procs->priority[running]);
+    p->procs->vruntime[running] += per_tick * ticks;
+    *budget -= ticks;
+}
+
+static const policy_ops_t fcfs_ops = {
+    .name = "fcfs", .label = "FCFS",
+    .init = fifo_init, .pick_next = fcfs_pick, .slice = whole_burst,
+};
+static const policy_ops_t sjf_ops = {
+    .name = "sjf", .label = "SJF",
+    .init = remaining_init, .pick_next = sjf_pick, .slice = whole_burst,
+};
+static const policy_ops_t srtf_ops = {
+    .name = "srtf", .label = "SRTF",
+    .init = remaining_init, .pick_next = srtf_pick, .slice = srtf_slice,
+};
+static const policy_ops_t rr_ops = {
+    .name = "rr", .label = "RR", .needs_quantum = true,
+    .init = fifo_init, .pick_next = rr_pick, .slice = budget_slice, .on_tick = spend_budget,
+};
+static const policy_ops_t priority_ops = {
+    .name = "priority", .label = "PRIORITY", .uses_aging = true,
+    .init = priority_init, .pick_next = priority_pick, .slice = priority_slice,
+};
+static const policy_ops_t mlfq_ops = {
+    .name = "mlfq", .label = "MLFQ",
+    .init = mlfq_init, .destroy = mlfq_destroy, .on_clock = mlfq_clock,
+    .pick_next = mlfq_pick, .slice = mlfq_slice, .on_tick = spend_budget,
+};
+static const policy_ops_t cfs_ops = {
+    .name = "cfs", .label = "CFS",
+    .init = cfs_init, .pick_next = cfs_pick, .slice = budget_slice, .on_tick = cfs_tick,
+};
+
+// ---- registry ----
+
+#define POLICY_MAX 32
+
+static const policy_ops_t *registry[POLICY_MAX] = {
+    &fcfs_ops, &sjf_ops, &srtf_ops, &rr_ops, &priority_ops, &mlfq_ops, &cfs_ops,
+};
+static int nregistered = 7;
+
+int policy_register(const policy_ops_t *ops) {
+    if (nregistered == POLICY_MAX || !ops->name || !ops->label || !ops->init || !ops->pick_next ||
+        policy_find(ops->name))
+        return -1;
+    registry[nregistered++] = ops;
+    return 0;
+}
+
+const policy_ops_t *policy_find(const char *name) {
+    for (int k = 0; k < nregistered; ++k)
+        if (strcasecmp(registry[k]->name, name) == 0) return registry[k];
+    return NULL;
+}
+
+int policy_count(void) { return nregistered; }
+
+const policy_ops_t *policy_at(int k) {
+    return (k >= 0 && k < nregistered) ? registry[k] : NULL;
+}
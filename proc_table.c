@@ -0,0 +1,80 @@
+// proc_table.c — growable structure-of-arrays process table (see scheduler_wiring.h)
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "scheduler_wiring.h"
+
+void pt_init(proc_table_t *t) {
+    memset(t, 0, sizeof *t);
+}
+
+#define GROW(col, type, cap) ((col) = (type*)realloc((col), sizeof(type) * (size_t)(cap)))
+
+void pt_reserve(proc_table_t *t, int cap) {
+    if (cap <= t->cap) return;
+    if (!t->map) {   // a mapped table's inputs and PIDs live in the trace
+        GROW(t->arrival,  int, cap);
+        GROW(t->burst,    int, cap);
+        GROW(t->priority, int, cap);
+        GROW(t->pid_off,  uint32_t, cap + 1);
+        if (t->cap == 0) t->pid_off[0] = 0;
+    }
+    GROW(t->remaining,     int, cap);
+    GROW(t->ready_since,   int, cap);
+    GROW(t->level,         int, cap);
+    GROW(t->vruntime,      int64_t, cap);
+    GROW(t->started_time,  int, cap);
+    GROW(t->finish_time,   int, cap);
+    GROW(t->response_time, int, cap);
+    GROW(t->waiting_time,  int, cap);
+    GROW(t->done,          bool, cap);
+    t->cap = cap;
+}
+
+int pt_append(proc_table_t *t, const char *pid, int pid_len,
+              int arrival, int burst, int priority) {
+    if (t->n == t->cap) pt_reserve(t, t->cap ? t->cap * 2 : 1024);
+    if (t->pid_len + (size_t)pid_len > t->pid_cap) {
+        t->pid_cap = t->pid_cap ? t->pid_cap * 2 : 8192;
+        while (t->pid_len + (size_t)pid_len > t->pid_cap) t->pid_cap *= 2;
+        t->pid_str = (char*)realloc(t->pid_str, t->pid_cap);
+    }
+    int i = t->n++;
+    memcpy(t->pid_str + t->pid_len, pid, (size_t)pid_len);
+    t->pid_len += (size_t)pid_len;
+    t->pid_off[i + 1] = (uint32_t)t->pid_len;
+    t->arrival[i]  = arrival;
+    t->burst[i]    = burst;
+    t->priority[i] = priority;
+    return i;
+}
+
+// Initialize fields expected by the scheduler core
+void pt_reset(proc_table_t *t) {
+    int n = t->n;
+    memcpy(t->remaining, t->burst, sizeof(int) * (size_t)n);
+    for (int i = 0; i < n; ++i) {
+        t->started_time[i] = -1;
+        t->finish_time[i]  = -1;
+    }
+    memset(t->response_time, 0, sizeof(int) * (size_t)n);
+    memset(t->waiting_time,  0, sizeof(int) * (size_t)n);
+    memset(t->level,         0, sizeof(int) * (size_t)n);
+    memset(t->vruntime,      0, sizeof(int64_t) * (size_t)n);
+    memset(t->done,          0, sizeof(bool) * (size_t)n);
+}
+
+void pt_free(proc_table_t *t) {
+    if (t->map) {
+        munmap(t->map, t->map_len);
+    } else {
+        free(t->arrival); free(t->burst); free(t->priority);
+        free(t->pid_id); free(t->pid_off); free(t->pid_str);
+    }
+    free(t->remaining); free(t->ready_since);
+    free(t->level); free(t->vruntime);
+    free(t->started_time); free(t->finish_time);
+    free(t->response_time); free(t->waiting_time);
+    free(t->done);
+    memset(t, 0, sizeof *t);
+}
@@ -1,77 +1,135 @@
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
 #include <string.h>
 #include <stdbool.h>
 #include <pthread.h>
-
-/* -------- Portable per-proc gate (replaces unnamed POSIX semaphores) -------- */
-typedef struct {
-    pthread_mutex_t mu;
-    pthread_cond_t  cv;
-    int             count;   // acts like a counting semaphore
-} gate_t;
-
-static inline void gate_init(gate_t *g, int initial) {
-    pthread_mutex_init(&g->mu, NULL);
-    pthread_cond_init(&g->cv, NULL);
-    g->count = (initial < 0) ? 0 : initial;
-}
-static inline void gate_destroy(gate_t *g) {
-    pthread_cond_destroy(&g->cv);
-    pthread_mutex_destroy(&g->mu);
-}
-static inline void gate_post(gate_t *g) {
-    pthread_mutex_lock(&g->mu);
-    g->count += 1;
-    pthread_cond_signal(&g->cv);
-    pthread_mutex_unlock(&g->mu);
-}
-static inline void gate_wait(gate_t *g) {
-    pthread_mutex_lock(&g->mu);
-    while (g->count == 0) pthread_cond_wait(&g->cv, &g->mu);
-    g->count -= 1;
-    pthread_mutex_unlock(&g->mu);
-}
-/* --------------------------------------------------------------------------- */
-
-typedef struct {
-    int *idx;               
-    int cap, head, tail, len;
-    pthread_mutex_t mu;    
-} readyq_t;
-
-typedef struct {
-    char pid[32];
-    int arrival, burst, priority;
-    int remaining, started_time, finish_time, response_time, waiting_time;
-    bool admitted, done;
-    gate_t run_gate;        
-} proc_t;
-
-
-// ---- API (used by your CLI / main.c) ----
-void rq_init(readyq_t *q, int capacity);
-void rq_destroy(readyq_t *q);
-bool rq_empty(readyq_t *q);
-void rq_push(readyq_t *q, int proc_index);
-int  rq_pop_fcfs(readyq_t *q);
-int  rq_pop_min_remaining(readyq_t *q, const proc_t *procs);   // SJF helper
-int  rq_pop_best_priority(readyq_t *q, const proc_t *procs);   // Priority helper
+#include "scheduler_wiring.h"   // gate_t, readyq_t, proc_table_t + rq_* API
 
 // ---- implementation ----
-void rq_init(readyq_t *q, int capacity) {
-    q->idx  = (int*)malloc(sizeof(int) * capacity);
-    q->cap  = capacity;
+/* FIFO ring over proc indices [0, nprocs). A membership bitset makes the
+   duplicate check O(1), and since every proc is queued at most once a ring of
+   nprocs slots can never overflow. */
+void rq_init(readyq_t *q, int nprocs) {
+    memset(q, 0, sizeof *q);
+    q->idx    = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    q->cap    = nprocs > 0 ? nprocs : 1;
     q->head = q->tail = q->len = 0;
+    q->kind   = RQ_FIFO;
+    q->member = (uint64_t*)calloc((size_t)(q->cap + 63) / 64 + 1, sizeof(uint64_t));
+    pthread_mutex_init(&q->mu, NULL);
+}
+
+static inline bool member_test(const readyq_t *q, int i) { return (q->member[i >> 6] >> (i & 63)) & 1u; }
+static inline void member_set  (readyq_t *q, int i) { q->member[i >> 6] |=  (uint64_t)1 << (i & 63); }
+static inline void member_clear(readyq_t *q, int i) { q->member[i >> 6] &= ~((uint64_t)1 << (i & 63)); }
+
+/* Indexed min-heap over proc indices [0, nprocs): O(log n) push/pop and
+   no allocation after init. The key is read from the proc table when a proc is pushed. */
+void rq_init_heap(readyq_t *q, int nprocs, const proc_table_t *procs, rq_key_t key) {
+    memset(q, 0, sizeof *q);
+    q->idx   = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    q->cap   = nprocs;
+    q->kind  = RQ_HEAP;
+    q->key   = key;
+    q->procs = procs;
+    q->pos   = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    q->hkey  = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    q->hseq  = (unsigned*)malloc(sizeof(unsigned) * (nprocs > 0 ? nprocs : 1));
+    for (int i = 0; i < nprocs; ++i) q->pos[i] = -1;
     pthread_mutex_init(&q->mu, NULL);
 }
 
+/* One FIFO list per MLFQ level, linked through per-proc next/prev slots: O(1)
+   push, pop and steal, and a boost splices whole lists in O(levels). */
+void rq_init_levels(readyq_t *q, int nprocs, const proc_table_t *procs) {
+    rq_init(q, nprocs);
+    free(q->idx); q->idx = NULL;   // lists, no ring
+    q->kind  = RQ_LEVELS;
+    q->procs = procs;
+    q->lnext = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    q->lprev = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    for (int l = 0; l < MLFQ_MAX_LEVELS; ++l) q->lhead[l] = q->ltail[l] = -1;
+}
+
+/* Red-black tree over proc indices [0, nprocs) for CFS: O(log n) push, pop
+   and steal, no allocation after init. Node k is proc k - 1, so the shared
+   leaf (node 0) stays put when the queue grows. */
+void rq_init_tree(readyq_t *q, int nprocs, const proc_table_t *procs) {
+    rq_init(q, nprocs);
+    free(q->idx); q->idx = NULL;   // tree, no ring
+    q->kind      = RQ_TREE;
+    q->procs     = procs;
+    q->hseq      = (unsigned*)malloc(sizeof(unsigned) * (nprocs > 0 ? nprocs : 1));
+    q->rb_left   = (int*)malloc(sizeof(int) * (nprocs + 1));
+    q->rb_right  = (int*)malloc(sizeof(int) * (nprocs + 1));
+    q->rb_parent = (int*)malloc(sizeof(int) * (nprocs + 1));
+    q->rb_red    = (uint8_t*)calloc(nprocs + 1, 1);
+    q->rb_left[0] = q->rb_right[0] = q->rb_parent[0] = 0;
+}
+
+/* Grow a queue to cover proc indices [0, nprocs), keeping its contents and
+   order. procs is the (possibly regrown) table heap keys and levels are read from. */
+void rq_reserve(readyq_t *q, int nprocs, const proc_table_t *procs) {
+    pthread_mutex_lock(&q->mu);
+    if (nprocs > q->cap) {
+        if (q->kind == RQ_HEAP) {
+            q->idx  = (int*)realloc(q->idx, sizeof(int) * nprocs);
+            q->pos  = (int*)realloc(q->pos, sizeof(int) * nprocs);
+            q->hkey = (int*)realloc(q->hkey, sizeof(int) * nprocs);
+            q->hseq = (unsigned*)realloc(q->hseq, sizeof(unsigned) * nprocs);
+            for (int i = q->cap; i < nprocs; ++i) q->pos[i] = -1;
+        } else if (q->kind == RQ_LEVELS) {
+            q->lnext = (int*)realloc(q->lnext, sizeof(int) * nprocs);
+            q->lprev = (int*)realloc(q->lprev, sizeof(int) * nprocs);
+        } else if (q->kind == RQ_TREE) {
+            q->hseq      = (unsigned*)realloc(q->hseq, sizeof(unsigned) * nprocs);
+            q->rb_left   = (int*)realloc(q->rb_left, sizeof(int) * (nprocs + 1));
+            q->rb_right  = (int*)realloc(q->rb_right, sizeof(int) * (nprocs + 1));
+            q->rb_parent = (int*)realloc(q->rb_parent, sizeof(int) * (nprocs + 1));
+            q->rb_red    = (uint8_t*)realloc(q->rb_red, nprocs + 1);
+        } else {
+            int *ring = (int*)malloc(sizeof(int) * nprocs);
+            for (int k = 0, p = q->head; k < q->len; ++k, p = (p + 1) % q->cap) ring[k] = q->idx[p];
+            free(q->idx);
+            q->idx = ring;
+            q->head = 0; q->tail = q->len;
+        }
+        if (q->kind != RQ_HEAP) {
+            size_t old_words = (size_t)(q->cap + 63) / 64 + 1, words = (size_t)(nprocs + 63) / 64 + 1;
+            q->member = (uint64_t*)realloc(q->member, sizeof(uint64_t) * words);
+            memset(q->member + old_words, 0, sizeof(uint64_t) * (words - old_words));
+        }
+        q->cap = nprocs;
+    }
+    q->procs = procs;
+    pthread_mutex_unlock(&q->mu);
+}
+
 void rq_destroy(readyq_t *q) {
     if (!q) return;
     free(q->idx); q->idx = NULL;
+    free(q->pos); q->pos = NULL;
+    free(q->hkey); q->hkey = NULL;
+    free(q->hseq); q->hseq = NULL;
+    free(q->member); q->member = NULL;
+    free(q->lnext); q->lnext = NULL;
+    free(q->lprev); q->lprev = NULL;
+    free(q->rb_left); q->rb_left = NULL;
+    free(q->rb_right); q->rb_right = NULL;
+    free(q->rb_parent); q->rb_parent = NULL;
+    free(q->rb_red); q->rb_red = NULL;
     q->cap = q->head = q->tail = q->len = 0;
     pthread_mutex_destroy(&q->mu);
 }
 
+int rq_len(readyq_t *q) {
+    pthread_mutex_lock(&q->mu);
+    int len = q->len;
+    pthread_mutex_unlock(&q->mu);
+    return len;
+}
+
 /* (fix #1) Make rq_empty synchronized to avoid data race on len */
 bool rq_empty(readyq_t *q) {
     bool empty;
@@ -81,74 +139,451 @@ bool rq_empty(readyq_t *q) {
     return empty;
 }
 
-/* Idempotent push (ignores duplicates) + (fix #2) capacity guard (non-blocking drop) */
+/* ---- heap internals (caller holds q->mu) ---- */
+static inline bool heap_less(const readyq_t *q, int a, int b) {
+    if (q->hkey[a] != q->hkey[b]) return q->hkey[a] < q->hkey[b];
+    return q->hseq[a] < q->hseq[b];
+}
+
+static inline void heap_place(readyq_t *q, int slot, int i) {
+    q->idx[slot] = i;
+    q->pos[i] = slot;
+}
+
+static void heap_sift_up(readyq_t *q, int slot) {
+    int i = q->idx[slot];
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (!heap_less(q, i, q->idx[parent])) break;
+        heap_place(q, slot, q->idx[parent]);
+        slot = parent;
+    }
+    heap_place(q, slot, i);
+}
+
+static void heap_sift_down(readyq_t *q, int slot) {
+    int i = q->idx[slot];
+    for (;;) {
+        int c = 2 * slot + 1;
+        if (c >= q->len) break;
+        if (c + 1 < q->len && heap_less(q, q->idx[c + 1], q->idx[c])) c++;
+        if (!heap_less(q, q->idx[c], i)) break;
+        heap_place(q, slot, q->idx[c]);
+        slot = c;
+    }
+    heap_place(q, slot, i);
+}
+
+static int heap_pop_unlocked(readyq_t *q) {
+    if (q->len == 0) return -1;
+    int top = q->idx[0];
+    q->pos[top] = -1;
+    if (--q->len > 0) {
+        q->idx[0] = q->idx[q->len];
+        heap_sift_down(q, 0);
+    }
+    return top;
+}
+
+static void heap_push_unlocked(readyq_t *q, int i) {
+    if (q->pos[i] >= 0) { q->dup_rejects++; return; }   // already queued
+    switch (q->key) {
+        case RQ_KEY_PRIORITY: q->hkey[i] = q->procs->priority[i]; break;
+        case RQ_KEY_AGED:     q->hkey[i] = q->procs->priority[i] + q->procs->ready_since[i] / q->age_ticks; break;
+        default:              q->hkey[i] = q->procs->remaining[i]; break;
+    }
+    q->hseq[i] = q->next_seq++;
+    q->idx[q->len] = i;
+    q->pos[i] = q->len;
+    q->len++;
+    heap_sift_up(q, q->len - 1);
+}
+
+/* ---- level list internals (caller holds q->mu) ---- */
+static void levels_push_unlocked(readyq_t *q, int i) {
+    if (member_test(q, i)) { q->dup_rejects++; return; }
+    member_set(q, i);
+    int l = q->procs->level[i];
+    q->lnext[i] = -1;
+    q->lprev[i] = q->ltail[l];
+    if (q->ltail[l] >= 0) q->lnext[q->ltail[l]] = i; else q->lhead[l] = i;
+    q->ltail[l] = i;
+    q->len++;
+}
+
+// Unlink i from level l's list and record l as its level
+static int levels_remove_unlocked(readyq_t *q, int l, int i) {
+    int prev = q->lprev[i], next = q->lnext[i];
+    if (prev >= 0) q->lnext[prev] = next; else q->lhead[l] = next;
+    if (next >= 0) q->lprev[next] = prev; else q->ltail[l] = prev;
+    member_clear(q, i);
+    q->len--;
+    q->procs->level[i] = l;
+    return i;
+}
+
+/* ---- red-black tree internals (caller holds q->mu) ----
+   CLRS insert/delete with node 0 as the black sentinel leaf; its parent link
+   is scratch space during a delete. */
+static inline bool rb_less(const readyq_t *q, int a, int b) {
+    int64_t va = q->procs->vruntime[a - 1], vb = q->procs->vruntime[b - 1];
+    if (va != vb) return va < vb;
+    return q->hseq[a - 1] < q->hseq[b - 1];
+}
+
+static void rb_rotate_left(readyq_t *q, int x) {
+    int *L = q->rb_left, *R = q->rb_right, *P = q->rb_parent;
+    int y = R[x];
+    R[x] = L[y];
+    if (L[y]) P[L[y]] = x;
+    P[y] = P[x];
+    if (!P[x]) q->rb_root = y; else if (x == L[P[x]]) L[P[x]] = y; else R[P[x]] = y;
+    L[y] = x;
+    P[x] = y;
+}
+
+static void rb_rotate_right(readyq_t *q, int x) {
+    int *L = q->rb_left, *R = q->rb_right, *P = q->rb_parent;
+    int y = L[x];
+    L[x] = R[y];
+    if (R[y]) P[R[y]] = x;
+    P[y] = P[x];
+    if (!P[x]) q->rb_root = y; else if (x == R[P[x]]) R[P[x]] = y; else L[P[x]] = y;
+    R[y] = x;
+    P[x] = y;
+}
+
+static void rb_insert(readyq_t *q, int z) {
+    int *L = q->rb_left, *R = q->rb_right, *P = q->rb_parent;
+    uint8_t *red = q->rb_red;
+    int y = 0, x = q->rb_root;
+    while (x) { y = x; x = rb_less(q, z, x) ? L[x] : R[x]; }
+    P[z] = y;
+    if (!y) q->rb_root = z; else if (rb_less(q, z, y)) L[y] = z; else R[y] = z;
+    L[z] = R[z] = 0;
+    red[z] = 1;
+    if (!q->rb_first || rb_less(q, z, q->rb_first)) q->rb_first = z;
+
+    while (red[P[z]]) {
+        int g = P[P[z]];
+        if (P[z] == L[g]) {
+            int u = R[g];
+            if (red[u]) { red[P[z]] = 0; red[u] = 0; red[g] = 1; z = g; continue; }
+            if (z == R[P[z]]) { z = P[z]; rb_rotate_left(q, z); }
+            red[P[z]] = 0; red[P[P[z]]] = 1; rb_rotate_right(q, P[P[z]]);
+        } else {
+            int u = L[g];
+            if (red[u]) { red[P[z]] = 0; red[u] = 0; red[g] = 1; z = g; continue; }
+            if (z == L[P[z]]) { z = P[z]; rb_rotate_right(q, z); }
+            red[P[z]] = 0; red[P[P[z]]] = 1; rb_rotate_left(q, P[P[z]]);
+        }
+    }
+    red[q->rb_root] = 0;
+}
+
+static inline int rb_min(const readyq_t *q, int x) { while (q->rb_left[x]) x = q->rb_left[x]; return x; }
+
+static void rb_transplant(readyq_t *q, int u, int v) {
+    int *P = q->rb_parent;
+    if (!P[u]) q->rb_root = v; else if (u == q->rb_left[P[u]]) q->rb_left[P[u]] = v; else q->rb_right[P[u]] = v;
+    P[v] = P[u];
+}
+
+static void rb_erase(readyq_t *q, int z) {
+    int *L = q->rb_left, *R = q->rb_right, *P = q->rb_parent;
+    uint8_t *red = q->rb_red;
+    if (z == q->rb_first) q->rb_first = R[z] ? rb_min(q, R[z]) : P[z];   // leftmost has no left child
+
+    int y = z, x;
+    uint8_t y_red = red[y];
+    if (!L[z]) {
+        x = R[z]; rb_transplant(q, z, R[z]);
+    } else if (!R[z]) {
+        x = L[z]; rb_transplant(q, z, L[z]);
+    } else {
+        y = rb_min(q, R[z]); y_red = red[y]; x = R[y];
+        if (P[y] == z) P[x] = y;
+        else { rb_transplant(q, y, R[y]); R[y] = R[z]; P[R[y]] = y; }
+        rb_transplant(q, z, y);
+        L[y] = L[z]; P[L[y]] = y; red[y] = red[z];
+    }
+    if (y_red) return;
+
+    while (x != q->rb_root && !red[x]) {
+        if (x == L[P[x]]) {
+            int w = R[P[x]];
+            if (red[w]) { red[w] = 0; red[P[x]] = 1; rb_rotate_left(q, P[x]); w = R[P[x]]; }
+            if (!red[L[w]] && !red[R[w]]) { red[w] = 1; x = P[x]; continue; }
+            if (!red[R[w]]) { red[L[w]] = 0; red[w] = 1; rb_rotate_right(q, w); w = R[P[x]]; }
+            red[w] = red[P[x]]; red[P[x]] = 0; red[R[w]] = 0; rb_rotate_left(q, P[x]);
+        } else {
+            int w = L[P[x]];
+            if (red[w]) { red[w] = 0; red[P[x]] = 1; rb_rotate_right(q, P[x]); w = L[P[x]]; }
+            if (!red[L[w]] && !red[R[w]]) { red[w] = 1; x = P[x]; continue; }
+            if (!red[L[w]]) { red[R[w]] = 0; red[w] = 1; rb_rotate_left(q, w); w = L[P[x]]; }
+            red[w] = red[P[x]]; red[P[x]] = 0; red[L[w]] = 0; rb_rotate_right(q, P[x]);
+        }
+        x = q->rb_root;
+    }
+    red[x] = 0;
+}
+
+static void tree_push_unlocked(readyq_t *q, int i) {
+    if (member_test(q, i)) { q->dup_rejects++; return; }
+    member_set(q, i);
+    int64_t *vr = q->procs->vruntime;
+    if (vr[i] < q->min_vruntime) vr[i] = q->min_vruntime;
+    q->hseq[i] = q->next_seq++;
+    rb_insert(q, i + 1);
+    q->load += cfs_weight(q->procs->priority[i]);
+    q->len++;
+}
+
+static int tree_remove_unlocked(readyq_t *q, int node) {
+    int i = node - 1;
+    rb_erase(q, node);
+    member_clear(q, i);
+    q->load -= cfs_weight(q->procs->priority[i]);
+    q->len--;
+    return i;
+}
+
+/* Every queue covers proc indices [0, cap); anything outside (a caller that
+   forgot rq_reserve) is dropped and counted rather than written past the end */
+static inline bool push_out_of_range(readyq_t *q, int i) {
+    if (i >= 0 && i < q->cap) return false;
+    q->cap_drops++;
+    return true;
+}
+
+/* Idempotent push (ignores duplicates, counting them). Membership is an O(1)
+   bit test; the ring holds one slot per proc, so a non-duplicate push always
+   fits. */
 void rq_push(readyq_t *q, int i) {
     pthread_mutex_lock(&q->mu);
 
-    // reject duplicates
-    int p = q->head;
-    for (int k = 0; k < q->len; ++k, p = (p + 1) % q->cap) {
-        if (q->idx[p] == i) { pthread_mutex_unlock(&q->mu); return; }
+    if (push_out_of_range(q, i)) {
+        pthread_mutex_unlock(&q->mu);
+        return;
     }
-
-    // capacity guard: drop if full (simple/non-blocking)
-    if (q->len == q->cap) {
+    if (q->kind == RQ_HEAP) {
+        heap_push_unlocked(q, i);
         pthread_mutex_unlock(&q->mu);
         return;
     }
+    if (q->kind == RQ_LEVELS) {
+        levels_push_unlocked(q, i);
+        pthread_mutex_unlock(&q->mu);
+        return;
+    }
+    if (q->kind == RQ_TREE) {
+        tree_push_unlocked(q, i);
+        pthread_mutex_unlock(&q->mu);
+        return;
+    }
+
+    // reject duplicates
+    if (member_test(q, i)) { q->dup_rejects++; pthread_mutex_unlock(&q->mu); return; }
 
+    member_set(q, i);
     q->idx[q->tail] = i;
     q->tail = (q->tail + 1) % q->cap;
     q->len++;
     pthread_mutex_unlock(&q->mu);
 }
 
+/* Push a batch under a single lock acquisition, same semantics as rq_push */
+void rq_push_bulk(readyq_t *q, const int *ids, int n) {
+    pthread_mutex_lock(&q->mu);
+    for (int k = 0; k < n; ++k) {
+        int i = ids[k];
+        if (push_out_of_range(q, i)) continue;
+        if (q->kind == RQ_HEAP) { heap_push_unlocked(q, i); continue; }
+        if (q->kind == RQ_LEVELS) { levels_push_unlocked(q, i); continue; }
+        if (q->kind == RQ_TREE)   { tree_push_unlocked(q, i); continue; }
+        if (member_test(q, i)) { q->dup_rejects++; continue; }
+        member_set(q, i);
+        q->idx[q->tail] = i;
+        q->tail = (q->tail + 1) % q->cap;
+        q->len++;
+    }
+    pthread_mutex_unlock(&q->mu);
+}
+
 int rq_pop_fcfs(readyq_t *q) {
     pthread_mutex_lock(&q->mu);
     if (q->len == 0) { pthread_mutex_unlock(&q->mu); return -1; }
+    if (q->kind == RQ_HEAP) {   // no arrival order in a heap: hand back the min
+        int i = heap_pop_unlocked(q);
+        pthread_mutex_unlock(&q->mu);
+        return i;
+    }
+    if (q->kind == RQ_LEVELS) {   // head of the best non-empty level
+        int l = 0;
+        while (q->lhead[l] < 0) l++;
+        int i = levels_remove_unlocked(q, l, q->lhead[l]);
+        pthread_mutex_unlock(&q->mu);
+        return i;
+    }
+    if (q->kind == RQ_TREE) {     // leftmost: least vruntime, oldest on ties
+        int i = tree_remove_unlocked(q, q->rb_first);
+        if (q->procs->vruntime[i] > q->min_vruntime) q->min_vruntime = q->procs->vruntime[i];
+        pthread_mutex_unlock(&q->mu);
+        return i;
+    }
     int i = q->idx[q->head];
     q->head = (q->head + 1) % q->cap;
     q->len--;
+    member_clear(q, i);
     pthread_mutex_unlock(&q->mu);
     return i;
 }
 
+/* Compact the ring in place, preserving order (no temp buffer) */
 static int remove_entry_unlocked(readyq_t *q, int target) {
-    int *tmp = (int*)malloc(sizeof(int) * q->cap);
     int p = q->head, tail = 0;
     for (int k = 0; k < q->len; ++k, p = (p + 1) % q->cap) {
         int v = q->idx[p];
-        if (v != target) tmp[tail++] = v;
+        if (v != target) q->idx[(q->head + tail++) % q->cap] = v;
     }
-    memcpy(q->idx, tmp, sizeof(int) * tail);
-    q->head = 0; q->tail = tail; q->len = tail;
-    free(tmp);
+    q->tail = (q->head + tail) % q->cap; q->len = tail;
+    member_clear(q, target);
     return target;
 }
 
 /* (fix #4) Reads of procs[] under q->mu; writers must hold q->mu too */
-int rq_pop_min_remaining(readyq_t *q, const proc_t *procs) {
+int rq_pop_min_remaining(readyq_t *q, const proc_table_t *procs) {
     pthread_mutex_lock(&q->mu);
     if (q->len == 0) { pthread_mutex_unlock(&q->mu); return -1; }
+    if (q->kind == RQ_HEAP && q->key == RQ_KEY_REMAINING) {
+        int i = heap_pop_unlocked(q);
+        pthread_mutex_unlock(&q->mu);
+        return i;
+    }
     int best = -1, best_rem = 0x3fffffff, p = q->head;
     for (int k = 0; k < q->len; ++k, p = (p + 1) % q->cap) {
         int i = q->idx[p];
-        if (procs[i].remaining < best_rem) { best_rem = procs[i].remaining; best = i; }
+        if (procs->remaining[i] < best_rem) { best_rem = procs->remaining[i]; best = i; }
     }
     if (best >= 0) remove_entry_unlocked(q, best);
     pthread_mutex_unlock(&q->mu);
     return best;
 }
 
-int rq_pop_best_priority(readyq_t *q, const proc_t *procs) {
+int rq_pop_best_priority(readyq_t *q, const proc_table_t *procs) {
     pthread_mutex_lock(&q->mu);
     if (q->len == 0) { pthread_mutex_unlock(&q->mu); return -1; }
+    if (q->kind == RQ_HEAP && (q->key == RQ_KEY_PRIORITY || q->key == RQ_KEY_AGED)) {
+        int i = heap_pop_unlocked(q);
+        pthread_mutex_unlock(&q->mu);
+        return i;
+    }
     int best = -1, best_pr = 0x3fffffff, p = q->head;
     for (int k = 0; k < q->len; ++k, p = (p + 1) % q->cap) {
         int i = q->idx[p];
-        if (procs[i].priority < best_pr) { best_pr = procs[i].priority; best = i; }
+        if (procs->priority[i] < best_pr) { best_pr = procs->priority[i]; best = i; }
     }
     if (best >= 0) remove_entry_unlocked(q, best);
     pthread_mutex_unlock(&q->mu);
     return best;
 }
+
+/* Best (lowest) priority value currently queued, without popping; INT_MAX if
+   empty. With aging this is the best aged key. */
+int rq_min_priority(readyq_t *q, const proc_table_t *procs) {
+    pthread_mutex_lock(&q->mu);
+    if (q->kind == RQ_HEAP && (q->key == RQ_KEY_PRIORITY || q->key == RQ_KEY_AGED)) {
+        int best_pr = (q->len > 0) ? q->hkey[q->idx[0]] : INT_MAX;
+        pthread_mutex_unlock(&q->mu);
+        return best_pr;
+    }
+    int best_pr = INT_MAX, p = (q->kind == RQ_HEAP) ? 0 : q->head;
+    for (int k = 0; k < q->len; ++k) {
+        int i = q->idx[p];
+        if (procs->priority[i] < best_pr) best_pr = procs->priority[i];
+        p = (q->kind == RQ_HEAP) ? p + 1 : (p + 1) % q->cap;
+    }
+    pthread_mutex_unlock(&q->mu);
+    return best_pr;
+}
+
+/* Least remaining time currently queued, without popping; INT_MAX if empty */
+int rq_min_remaining(readyq_t *q, const proc_table_t *procs) {
+    pthread_mutex_lock(&q->mu);
+    if (q->kind == RQ_HEAP && q->key == RQ_KEY_REMAINING) {
+        int best = (q->len > 0) ? q->hkey[q->idx[0]] : INT_MAX;
+        pthread_mutex_unlock(&q->mu);
+        return best;
+    }
+    int best = INT_MAX, p = (q->kind == RQ_HEAP) ? 0 : q->head;
+    for (int k = 0; k < q->len; ++k) {
+        int i = q->idx[p];
+        if (procs->remaining[i] < best) best = procs->remaining[i];
+        p = (q->kind == RQ_HEAP) ? p + 1 : (p + 1) % q->cap;
+    }
+    pthread_mutex_unlock(&q->mu);
+    return best;
+}
+
+int rq_top_level(readyq_t *q) {
+    pthread_mutex_lock(&q->mu);
+    int top = INT_MAX;
+    if (q->kind == RQ_LEVELS && q->len > 0)
+        for (top = 0; q->lhead[top] < 0; ++top) {}
+    pthread_mutex_unlock(&q->mu);
+    return top;
+}
+
+/* Splice every lower level onto the end of level 0, in level order. Procs keep
+   their stale procs->level until they are popped. No-op for other kinds. */
+void rq_boost(readyq_t *q) {
+    pthread_mutex_lock(&q->mu);
+    if (q->kind == RQ_LEVELS) {
+        for (int l = 1; l < MLFQ_MAX_LEVELS; ++l) {
+            int h = q->lhead[l];
+            if (h < 0) continue;
+            if (q->ltail[0] >= 0) { q->lnext[q->ltail[0]] = h; q->lprev[h] = q->ltail[0]; }
+            else q->lhead[0] = h;
+            q->ltail[0] = q->ltail[l];
+            q->lhead[l] = q->ltail[l] = -1;
+        }
+    }
+    pthread_mutex_unlock(&q->mu);
+}
+
+long long rq_load(readyq_t *q) {
+    pthread_mutex_lock(&q->mu);
+    long long load = q->load;
+    pthread_mutex_unlock(&q->mu);
+    return load;
+}
+
+/* Take one proc off the back of the queue for another CPU's queue: the most
+   recently queued proc of a FIFO or of the worst non-empty level, the last
+   heap leaf (removing a leaf needs no sift), or the largest vruntime. -1 if
+   empty. */
+int rq_steal(readyq_t *q) {
+    pthread_mutex_lock(&q->mu);
+    int i = -1;
+    if (q->len > 0) {
+        if (q->kind == RQ_HEAP) {
+            i = q->idx[--q->len];
+            q->pos[i] = -1;
+        } else if (q->kind == RQ_LEVELS) {
+            int l = MLFQ_MAX_LEVELS - 1;
+            while (q->ltail[l] < 0) l--;
+            i = levels_remove_unlocked(q, l, q->ltail[l]);
+        } else if (q->kind == RQ_TREE) {
+            int x = q->rb_root;
+            while (q->rb_right[x]) x = q->rb_right[x];
+            i = tree_remove_unlocked(q, x);
+        } else {
+            q->tail = (q->tail + q->cap - 1) % q->cap;
+            i = q->idx[q->tail];
+            q->len--;
+            member_clear(q, i);
+        }
+    }
+    pthread_mutex_unlock(&q->mu);
+    return i;
+}
@@ -0,0 +1,487 @@
+// report.c — run reports: text, JSON, CSV and binary, all through outbuf_t
+#include <stdlib.h>
+#include <string.h>
+#include "report.h"
+
+// Part of the report still open, so the next call knows what to close
+enum { SEC_NONE, SEC_TIMELINE, SEC_ROWS, SEC_DONE };
+
+struct report {
+    outbuf_t     ob;
+    FILE        *f;
+    const char  *path;        // for error messages, NULL = stdout
+    output_fmt_t fmt;
+    bool         timeline, rows;
+    report_info_t info;
+    int          section;
+    long long    nitems;      // entries in the open section (JSON commas)
+};
+
+report_t *report_open(output_fmt_t fmt, const char *path, bool timeline, bool rows) {
+    FILE *f = stdout;
+    if (path && strcmp(path, "-") != 0) {
+        f = fopen(path, fmt == OUTPUT_BIN ? "wb" : "w");
+        if (!f) { perror(path); return NULL; }
+    } else {
+        path = NULL;
+    }
+    report_t *r = (report_t*)calloc(1, sizeof *r);
+    ob_init(&r->ob, f);
+    r->f = f;
+    r->path = path;
+    r->fmt = fmt;
+    r->timeline = timeline;
+    r->rows = rows;
+    return r;
+}
+
+bool report_wants_timeline(const report_t *r) { return r->timeline; }
+bool report_wants_rows(const report_t *r)     { return r->rows; }
+
+// ---- format helpers ----
+
+static void json_str(outbuf_t *ob, const char *s, int n) {
+    ob_putc(ob, '"');
+    for (int k = 0; k < n; ++k) {
+        unsigned char c = (unsigned char)s[k];
+        if (c == '"' || c == '\\') { ob_putc(ob, '\\'); ob_putc(ob, (char)c); }
+        else if (c < 0x20)         ob_printf(ob, "\\u%04x", c);
+        else                       ob_putc(ob, (char)c);
+    }
+    ob_putc(ob, '"');
+}
+
+static void csv_str(outbuf_t *ob, const char *s, int n) {
+    if (!memchr(s, ',', n) && !memchr(s, '"', n) && !memchr(s, '\n', n)) {
+        ob_write(ob, s, n);
+        return;
+    }
+    ob_putc(ob, '"');
+    for (int k = 0; k < n; ++k) {
+        if (s[k] == '"') ob_putc(ob, '"');
+        ob_putc(ob, s[k]);
+    }
+    ob_putc(ob, '"');
+}
+
+// "key":v, with the comma before every key but the first of an object
+static void json_key(outbuf_t *ob, const char *key, bool first) {
+    if (!first) ob_putc(ob, ',');
+    ob_putc(ob, '"');
+    ob_puts(ob, key);
+    ob_puts(ob, "\":");
+}
+
+static void bin_rec(outbuf_t *ob, uint32_t type, const void *body, size_t n, const char *tail, int tail_len) {
+    size_t padded = (n + (size_t)tail_len + 7) & ~(size_t)7;
+    report_rec_t rec = { type, (uint32_t)padded };
+    static const char zeros[8];
+    ob_write(ob, (const char*)&rec, sizeof rec);
+    ob_write(ob, (const char*)body, n);
+    if (tail_len > 0) ob_write(ob, tail, tail_len);
+    ob_write(ob, zeros, padded - n - (size_t)tail_len);
+}
+
+// Close the open section before a different one starts
+static void enter(report_t *r, int section) {
+    if (r->section == section) return;
+    outbuf_t *ob = &r->ob;
+    if (r->section == SEC_TIMELINE || r->section == SEC_ROWS) {
+        if (r->fmt == OUTPUT_JSON) ob_putc(ob, ']');
+        if (r->fmt == OUTPUT_CSV)  ob_putc(ob, '\n');   // blank line between sections
+        if (r->fmt == OUTPUT_TEXT && r->section == SEC_ROWS)
+            ob_puts(ob, "-------------------------------------\n");
+    }
+    r->section = section;
+    r->nitems = 0;
+    if (section == SEC_TIMELINE) {
+        if (r->fmt == OUTPUT_JSON) ob_puts(ob, ",\"timeline\":[");
+        if (r->fmt == OUTPUT_CSV)  ob_puts(ob, "cpu,start,end,pid\n");
+    } else if (section == SEC_ROWS) {
+        if (r->fmt == OUTPUT_JSON) ob_puts(ob, ",\"processes\":[");
+        if (r->fmt == OUTPUT_CSV)  ob_puts(ob, "pid,arrival,burst,start,finish,wait,resp,turn\n");
+        if (r->fmt == OUTPUT_TEXT) {
+            ob_puts(ob, "-------------------------------------\n");
+            ob_puts(ob, "PID       Arr  Burst  Start  Finish  Wait  Resp  Turn\n");
+        }
+    }
+}
+
+// ---- sections ----
+
+void report_begin(report_t *r, const report_info_t *info) {
+    outbuf_t *ob = &r->ob;
+    r->info = *info;
+    switch (r->fmt) {
+    case OUTPUT_TEXT:
+        if (info->streaming)
+            ob_printf(ob, "\n===== %s Scheduling (streaming) =====\n", info->policy);
+        else if (info->ncpus > 1)
+            ob_printf(ob, "\n===== %s Scheduling (%d CPUs, %s queue) =====\n", info->policy,
+                      info->ncpus, info->queue);
+        else
+            ob_printf(ob, "\n===== %s Scheduling =====\n", info->policy);
+        if (!info->streaming)
+            ob_printf(ob, "Finished in %d ticks. Processes: %d\n", info->makespan, info->nprocs);
+        break;
+    case OUTPUT_JSON:
+        ob_puts(ob, "{\"policy\":");
+        json_str(ob, info->policy, (int)strlen(info->policy));
+        ob_puts(ob, ",\"cpus\":");
+        ob_int(ob, info->ncpus);
+        if (info->ncpus > 1) {
+            ob_puts(ob, ",\"queue\":");
+            json_str(ob, info->queue, (int)strlen(info->queue));
+        }
+        ob_puts(ob, ",\"streaming\":");
+        ob_puts(ob, info->streaming ? "true" : "false");
+        break;
+    case OUTPUT_CSV:
+        break;
+    case OUTPUT_BIN: {
+        report_hdr_t h;
+        memset(&h, 0, sizeof h);
+        memcpy(h.magic, REPORT_MAGIC, sizeof h.magic);
+        h.version = REPORT_VERSION;
+        h.endian = REPORT_ENDIAN;
+        h.ncpus = (uint32_t)info->ncpus;
+        h.streaming = info->streaming;
+        strncpy(h.policy, info->policy, sizeof h.policy - 1);
+        ob_write(ob, (const char*)&h, sizeof h);
+        break;
+    }
+    }
+}
+
+void report_timeline(report_t *r, int cpu, const tl_seg_t *segs, int nsegs, const proc_table_t *procs) {
+    if (!r->timeline || !segs || nsegs <= 0) return;
+    outbuf_t *ob = &r->ob;
+
+    if (r->fmt == OUTPUT_TEXT) {   // one titled block per lane, not a section
+        if (r->info.ncpus > 1) ob_printf(ob, "\nTimeline (Gantt), CPU %d:\n", cpu);
+        else                   ob_puts(ob, "\nTimeline (Gantt):\n");
+        for (int k = 0; k < nsegs; ++k) {
+            ob_putc(ob, '[');
+            ob_int_w(ob, segs[k].start, 4);
+            ob_puts(ob, "..");
+            ob_int_w(ob, segs[k].end, 4);
+            ob_puts(ob, "): ");
+            if (segs[k].proc < 0) ob_puts(ob, "IDLE");
+            else ob_write(ob, pt_pid(procs, segs[k].proc), pt_pid_len(procs, segs[k].proc));
+            ob_putc(ob, '\n');
+        }
+        ob_putc(ob, '\n');
+        return;
+    }
+
+    enter(r, SEC_TIMELINE);
+    for (int k = 0; k < nsegs; ++k) {
+        const tl_seg_t *s = &segs[k];
+        switch (r->fmt) {
+        case OUTPUT_JSON:
+            if (r->nitems++) ob_putc(ob, ',');
+            ob_puts(ob, "{\"cpu\":");   ob_int(ob, cpu);
+            ob_puts(ob, ",\"start\":"); ob_int(ob, s->start);
+            ob_puts(ob, ",\"end\":");   ob_int(ob, s->end);
+            ob_puts(ob, ",\"pid\":");
+            if (s->proc < 0) ob_puts(ob, "null");
+            else json_str(ob, pt_pid(procs, s->proc), pt_pid_len(procs, s->proc));
+            ob_putc(ob, '}');
+            break;
+        case OUTPUT_CSV:
+            ob_int(ob, cpu);      ob_putc(ob, ',');
+            ob_int(ob, s->start); ob_putc(ob, ',');
+            ob_int(ob, s->end);   ob_putc(ob, ',');
+            if (s->proc >= 0) csv_str(ob, pt_pid(procs, s->proc), pt_pid_len(procs, s->proc));
+            ob_putc(ob, '\n');
+            break;
+        case OUTPUT_BIN: {
+            report_seg_t b = { cpu, s->start, s->end, s->proc };
+            bin_rec(ob, REPORT_REC_SEG, &b, sizeof b, NULL, 0);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void report_row(report_t *r, const proc_table_t *procs, int i, const char *pid, int pid_len) {
+    if (!r->rows) return;
+    outbuf_t *ob = &r->ob;
+    enter(r, SEC_ROWS);
+
+    int turn = procs->finish_time[i] - procs->arrival[i];
+    switch (r->fmt) {
+    case OUTPUT_TEXT:
+        ob_str_w(ob, pid, pid_len, 8);
+        ob_putc(ob, ' ');  ob_int_w(ob, procs->arrival[i], 4);
+        ob_puts(ob, "  "); ob_int_w(ob, procs->burst[i], 5);
+        ob_puts(ob, "  "); ob_int_w(ob, procs->started_time[i], 5);
+        ob_puts(ob, "  "); ob_int_w(ob, procs->finish_time[i], 6);
+        ob_puts(ob, "  "); ob_int_w(ob, procs->waiting_time[i], 4);
+        ob_puts(ob, "  "); ob_int_w(ob, procs->response_time[i], 4);
+        ob_puts(ob, "  "); ob_int_w(ob, turn, 4);
+        ob_putc(ob, '\n');
+        break;
+    case OUTPUT_JSON:
+        if (r->nitems++) ob_putc(ob, ',');
+        ob_puts(ob, "{\"pid\":");     json_str(ob, pid, pid_len);
+        ob_puts(ob, ",\"arrival\":"); ob_int(ob, procs->arrival[i]);
+        ob_puts(ob, ",\"burst\":");   ob_int(ob, procs->burst[i]);
+        ob_puts(ob, ",\"start\":");   ob_int(ob, procs->started_time[i]);
+        ob_puts(ob, ",\"finish\":");  ob_int(ob, procs->finish_time[i]);
+        ob_puts(ob, ",\"wait\":");    ob_int(ob, procs->waiting_time[i]);
+        ob_puts(ob, ",\"resp\":");    ob_int(ob, procs->response_time[i]);
+        ob_puts(ob, ",\"turn\":");    ob_int(ob, turn);
+        ob_putc(ob, '}');
+        break;
+    case OUTPUT_CSV:
+        csv_str(ob, pid, pid_len);
+        ob_putc(ob, ','); ob_int(ob, procs->arrival[i]);
+        ob_putc(ob, ','); ob_int(ob, procs->burst[i]);
+        ob_putc(ob, ','); ob_int(ob, procs->started_time[i]);
+        ob_putc(ob, ','); ob_int(ob, procs->finish_time[i]);
+        ob_putc(ob, ','); ob_int(ob, procs->waiting_time[i]);
+        ob_putc(ob, ','); ob_int(ob, procs->response_time[i]);
+        ob_putc(ob, ','); ob_int(ob, turn);
+        ob_putc(ob, '\n');
+        break;
+    case OUTPUT_BIN: {
+        report_proc_t b = { i, procs->arrival[i], procs->burst[i], procs->started_time[i],
+                            procs->finish_time[i], procs->waiting_time[i], procs->response_time[i],
+                            turn, pid_len, 0 };
+        bin_rec(ob, REPORT_REC_PROC, &b, sizeof b, pid, pid_len);
+        break;
+    }
+    }
+}
+
+void report_rows(report_t *r, const proc_table_t *procs) {
+    if (!r->rows) return;
+    for (int i = 0; i < procs->n; ++i) report_row(r, procs, i, pt_pid(procs, i), pt_pid_len(procs, i));
+}
+
+void report_percentiles(outbuf_t *ob, const metrics_t *M) {
+    ob_printf(ob, "\n%-5s %9s %9s %7s %7s %7s %7s\n", "", "Mean", "StdDev", "p50", "p95", "p99", "Max");
+    const struct { const char *name; const dist_summary_t *s; } rows[] = {
+        { "Wait", &M->wait }, { "Resp", &M->resp }, { "Turn", &M->turn },
+    };
+    for (int k = 0; k < 3; ++k) {
+        const dist_summary_t *s = rows[k].s;
+        ob_printf(ob, "%-5s %9.2f %9.2f %7d %7d %7d %7d\n",
+                  rows[k].name, s->mean, s->stddev, s->p50, s->p95, s->p99, s->max);
+    }
+}
+
+static void json_dist(outbuf_t *ob, const char *key, const dist_summary_t *s) {
+    json_key(ob, key, false);
+    ob_printf(ob, "{\"mean\":%.6f,\"stddev\":%.6f,\"p50\":%d,\"p95\":%d,\"p99\":%d,\"max\":%d}",
+              s->mean, s->stddev, s->p50, s->p95, s->p99, s->max);
+}
+
+static void csv_dist(outbuf_t *ob, const char *name, const dist_summary_t *s) {
+    ob_printf(ob, "%s_mean,%.6f\n%s_stddev,%.6f\n%s_p50,%d\n%s_p95,%d\n%s_p99,%d\n%s_max,%d\n",
+              name, s->mean, name, s->stddev, name, s->p50, name, s->p95, name, s->p99, name, s->max);
+}
+
+static report_dist_t bin_dist(const dist_summary_t *s) {
+    report_dist_t d = { s->mean, s->stddev, s->p50, s->p95, s->p99, s->max };
+    return d;
+}
+
+void report_summary(report_t *r, const metrics_t *M, int makespan,
+                    const char *max_pid, int max_pid_len, int peak_live) {
+    outbuf_t *ob = &r->ob;
+    enter(r, SEC_DONE);
+    if (!max_pid) max_pid_len = 0;
+
+    switch (r->fmt) {
+    case OUTPUT_TEXT:
+        if (r->info.streaming)
+            ob_printf(ob, "Finished in %d ticks. Processes: %lld (peak live: %d)\n",
+                      makespan, M->nprocs, peak_live);
+        ob_printf(ob, "Avg Wait = %.2f\n", M->avg_wait);
+        if (max_pid) ob_printf(ob, "Max Wait = %d (%.*s)\n", M->max_wait, max_pid_len, max_pid);
+        ob_printf(ob, "Avg Resp = %.2f\n", M->avg_resp);
+        ob_printf(ob, "Avg Turn = %.2f\n", M->avg_turn);
+        ob_printf(ob, "Throughput = %.3f jobs/unit time\n", M->throughput);
+        ob_printf(ob, "CPU Utilization = %.1f%%\n", M->cpu_utilization);
+        if (M->cores) {
+            ob_printf(ob, "Migrations = %ld\n", M->migrations);
+            ob_puts(ob, "\nCPU   Busy   Util%  Dispatch  Migrate  Steals\n");
+            for (int c = 0; c < M->ncpus; ++c) {
+                const core_metrics_t *K = &M->cores[c];
+                ob_printf(ob, "%3d  %5ld  %5.1f%%  %8ld  %7ld  %6ld\n",
+                          c, K->busy, K->utilization, K->dispatches, K->migrations, K->steals);
+            }
+        }
+        report_percentiles(ob, M);
+        break;
+
+    case OUTPUT_JSON:
+        ob_puts(ob, ",\"summary\":{");
+        json_key(ob, "makespan", true);  ob_int(ob, makespan);
+        json_key(ob, "procs", false);    ob_int(ob, M->nprocs);
+        if (peak_live >= 0) { json_key(ob, "peak_live", false); ob_int(ob, peak_live); }
+        json_key(ob, "avg_wait", false); ob_printf(ob, "%.6f", M->avg_wait);
+        json_key(ob, "max_wait", false); ob_int(ob, M->max_wait);
+        json_key(ob, "max_wait_pid", false);
+        if (max_pid) json_str(ob, max_pid, max_pid_len); else ob_puts(ob, "null");
+        json_key(ob, "avg_resp", false); ob_printf(ob, "%.6f", M->avg_resp);
+        json_key(ob, "avg_turn", false); ob_printf(ob, "%.6f", M->avg_turn);
+        json_key(ob, "throughput", false); ob_printf(ob, "%.6f", M->throughput);
+        json_key(ob, "cpu_utilization", false); ob_printf(ob, "%.6f", M->cpu_utilization);
+        json_dist(ob, "wait", &M->wait);
+        json_dist(ob, "resp", &M->resp);
+        json_dist(ob, "turn", &M->turn);
+        if (M->cores) {
+            json_key(ob, "migrations", false); ob_int(ob, M->migrations);
+            json_key(ob, "cores", false); ob_putc(ob, '[');
+            for (int c = 0; c < M->ncpus; ++c) {
+                const core_metrics_t *K = &M->cores[c];
+                ob_printf(ob, "%s{\"cpu\":%d,\"busy\":%ld,\"utilization\":%.6f,\"dispatches\":%ld,"
+                              "\"migrations\":%ld,\"steals\":%ld}",
+                          c ? "," : "", c, K->busy, K->utilization, K->dispatches, K->migrations, K->steals);
+            }
+            ob_putc(ob, ']');
+        }
+        ob_putc(ob, '}');
+        break;
+
+    case OUTPUT_CSV:
+        ob_puts(ob, "metric,value\n");
+        ob_printf(ob, "makespan,%d\nprocs,%lld\n", makespan, M->nprocs);
+        if (peak_live >= 0) ob_printf(ob, "peak_live,%d\n", peak_live);
+        ob_printf(ob, "avg_wait,%.6f\nmax_wait,%d\nmax_wait_pid,", M->avg_wait, M->max_wait);
+        if (max_pid) csv_str(ob, max_pid, max_pid_len);
+        ob_printf(ob, "\navg_resp,%.6f\navg_turn,%.6f\nthroughput,%.6f\ncpu_utilization,%.6f\n",
+                  M->avg_resp, M->avg_turn, M->throughput, M->cpu_utilization);
+        csv_dist(ob, "wait", &M->wait);
+        csv_dist(ob, "resp", &M->resp);
+        csv_dist(ob, "turn", &M->turn);
+        if (M->cores) {
+            ob_printf(ob, "migrations,%ld\n", M->migrations);
+            ob_puts(ob, "\ncpu,busy,utilization,dispatches,migrations,steals\n");
+            for (int c = 0; c < M->ncpus; ++c) {
+                const core_metrics_t *K = &M->cores[c];
+                ob_printf(ob, "%d,%ld,%.6f,%ld,%ld,%ld\n",
+                          c, K->busy, K->utilization, K->dispatches, K->migrations, K->steals);
+            }
+        }
+        break;
+
+    case OUTPUT_BIN: {
+        report_summary_t b;
+        memset(&b, 0, sizeof b);
+        b.nprocs = M->nprocs;
+        b.migrations = M->migrations;
+        b.makespan = makespan;
+        b.ncpus = M->ncpus;
+        b.max_wait = M->max_wait;
+        b.pid_len = max_pid_len;
+        b.peak_live = peak_live;
+        b.avg_wait = M->avg_wait;
+        b.avg_resp = M->avg_resp;
+        b.avg_turn = M->avg_turn;
+        b.throughput = M->throughput;
+        b.cpu_utilization = M->cpu_utilization;
+        b.wait = bin_dist(&M->wait);
+        b.resp = bin_dist(&M->resp);
+        b.turn = bin_dist(&M->turn);
+        bin_rec(ob, REPORT_REC_SUMMARY, &b, sizeof b, max_pid, max_pid_len);
+        for (int c = 0; M->cores && c < M->ncpus; ++c) {
+            const core_metrics_t *K = &M->cores[c];
+            report_core_t k = { c, 0, K->busy, K->dispatches, K->migrations, K->steals, K->utilization };
+            bin_rec(ob, REPORT_REC_CORE, &k, sizeof k, NULL, 0);
+        }
+        break;
+    }
+    }
+}
+
+// Counters and the phase split, in cycles and (calibrated over the run) ns
+void report_stats(report_t *r, const sched_stats_t *s) {
+    outbuf_t *ob = &r->ob;
+    enter(r, SEC_DONE);
+    double npc = stats_ns_per_clock(s);
+    double mean_depth = s->decisions ? (double)s->rq_depth_sum / s->decisions : 0;
+    const struct { const char *name; uint64_t t; } phases[] = {
+        { "admit", s->t_admit }, { "pick", s->t_pick }, { "handoff", s->t_handoff },
+        { "account", s->t_account }, { "run", s->run_clock },
+    };
+
+    switch (r->fmt) {
+    case OUTPUT_TEXT:
+        ob_puts(ob, "\nScheduler stats:\n");
+        ob_printf(ob, "Dispatches = %lld\n", s->dispatches);
+        ob_printf(ob, "Context Switches = %lld\n", s->context_switches);
+        ob_printf(ob, "Preemptions = %lld\n", s->preemptions);
+        ob_printf(ob, "Idle Ticks = %lld\n", s->idle_ticks);
+        ob_printf(ob, "Ready Queue Depth = %.2f avg, %d max (%lld decisions)\n",
+                  mean_depth, s->rq_depth_max, s->decisions);
+        ob_printf(ob, "Queue Rejects = %lld duplicate, %lld over capacity\n",
+                  s->rq_dup_rejects, s->rq_cap_drops);
+        if (s->handoff_waits)
+            ob_printf(ob, "Handoff Waits = %lld (%lld parked), worker parks = %lld\n",
+                      s->handoff_waits, s->handoff_parks, s->worker_parks);
+        ob_printf(ob, "\n%-8s %14s %12s %6s\n", "Phase", "Cycles", "ms", "%run");
+        for (int k = 0; k < 5; ++k)
+            ob_printf(ob, "%-8s %14llu %12.3f %5.1f%%\n", phases[k].name,
+                      (unsigned long long)phases[k].t, phases[k].t * npc / 1e6,
+                      s->run_clock ? 100.0 * phases[k].t / s->run_clock : 0.0);
+        break;
+
+    case OUTPUT_JSON:
+        ob_printf(ob, ",\"stats\":{\"dispatches\":%lld,\"context_switches\":%lld,\"preemptions\":%lld,"
+                      "\"idle_ticks\":%lld,\"decisions\":%lld,\"rq_depth_mean\":%.6f,\"rq_depth_max\":%d,"
+                      "\"rq_dup_rejects\":%lld,\"rq_cap_drops\":%lld,\"handoff_waits\":%lld,"
+                      "\"handoff_parks\":%lld,\"worker_parks\":%lld,\"ns_per_cycle\":%.6f,\"phases\":{",
+                  s->dispatches, s->context_switches, s->preemptions, s->idle_ticks, s->decisions,
+                  mean_depth, s->rq_depth_max, s->rq_dup_rejects, s->rq_cap_drops, s->handoff_waits,
+                  s->handoff_parks, s->worker_parks, npc);
+        for (int k = 0; k < 5; ++k)
+            ob_printf(ob, "%s\"%s\":{\"cycles\":%llu,\"ns\":%.0f}", k ? "," : "", phases[k].name,
+                      (unsigned long long)phases[k].t, phases[k].t * npc);
+        ob_puts(ob, "}}");
+        break;
+
+    case OUTPUT_CSV:
+        ob_puts(ob, "\nstat,value\n");
+        ob_printf(ob, "dispatches,%lld\ncontext_switches,%lld\npreemptions,%lld\nidle_ticks,%lld\n"
+                      "decisions,%lld\nrq_depth_mean,%.6f\nrq_depth_max,%d\nrq_dup_rejects,%lld\n"
+                      "rq_cap_drops,%lld\nhandoff_waits,%lld\nhandoff_parks,%lld\nworker_parks,%lld\n"
+                      "ns_per_cycle,%.6f\n",
+                  s->dispatches, s->context_switches, s->preemptions, s->idle_ticks, s->decisions,
+                  mean_depth, s->rq_depth_max, s->rq_dup_rejects, s->rq_cap_drops, s->handoff_waits,
+                  s->handoff_parks, s->worker_parks, npc);
+        for (int k = 0; k < 5; ++k)
+            ob_printf(ob, "%s_cycles,%llu\n%s_ns,%.0f\n", phases[k].name,
+                      (unsigned long long)phases[k].t, phases[k].name, phases[k].t * npc);
+        break;
+
+    case OUTPUT_BIN: {
+        report_stats_t b = {
+            s->dispatches, s->context_switches, s->preemptions, s->idle_ticks,
+            s->decisions, s->rq_depth_sum, s->rq_depth_max, s->rq_dup_rejects, s->rq_cap_drops,
+            s->handoff_waits, s->handoff_parks, s->worker_parks,
+            (int64_t)s->t_admit, (int64_t)s->t_pick, (int64_t)s->t_handoff, (int64_t)s->t_account,
+            (int64_t)s->run_clock, s->run_ns,
+        };
+        bin_rec(ob, REPORT_REC_STATS, &b, sizeof b, NULL, 0);
+        break;
+    }
+    }
+}
+
+int report_close(report_t *r) {
+    if (r->fmt == OUTPUT_JSON) {   // also when cut short, so it is still valid JSON
+        enter(r, SEC_DONE);
+        ob_puts(&r->ob, "}\n");
+    }
+    int rc = ob_close(&r->ob);
+    if (r->f != stdout && fclose(r->f) != 0) rc = -1;
+    if (rc != 0) fprintf(stderr, "%s: write failed\n", r->path ? r->path : "stdout");
+    free(r);
+    return rc;
+}
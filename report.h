@@ -0,0 +1,124 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <stdint.h>
+#include "cmdparser.h"   // output_fmt_t
+#include "metrics.h"
+#include "stats.h"
+#include "outbuf.h"
+
+/* Run reports in the format picked with --output, written through an
+ * outbuf_t to stdout or --out-file. A run calls, in order: report_begin,
+ * report_timeline once per CPU lane, report_row per process (or
+ * report_rows), report_summary, report_stats if --stats, then report_close. Timeline and rows are
+ * dropped when the report was opened without them (--quiet-gantt,
+ * --summary-only), so callers can also skip building them.
+ *
+ *   text  the human-readable report (the default)
+ *   json  one object: policy, cpus, timeline[], processes[], summary{}, stats{}
+ *   csv   blank-line separated sections, each with its own header row:
+ *         timeline (cpu,start,end,pid), processes, metric,value, cores,
+ *         stat,value
+ *   bin   report_hdr_t, then records (see below)
+ */
+
+/* Binary report (--output bin, native little-endian like the trace format):
+ *
+ *   report_hdr_t                       fixed-size header (40 bytes)
+ *   { report_rec_t; payload[len] }...  records; len is a multiple of 8
+ *
+ *   REPORT_REC_SEG      report_seg_t
+ *   REPORT_REC_PROC     report_proc_t, then pid_len PID bytes, zero padded
+ *   REPORT_REC_SUMMARY  report_summary_t, then the max-wait PID, zero padded
+ *   REPORT_REC_CORE     report_core_t, one per CPU of an SMP run
+ *   REPORT_REC_STATS    report_stats_t (--stats)
+ */
+#define REPORT_MAGIC   "SCHEDOUT"
+#define REPORT_VERSION 1u
+#define REPORT_ENDIAN  0x01020304u
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t endian;        // REPORT_ENDIAN as written by the producer
+    uint32_t ncpus;
+    uint32_t streaming;     // 1: proc indices are recycled slots, no timeline
+    char     policy[16];    // label, zero padded
+} report_hdr_t;
+
+enum { REPORT_REC_SEG = 1, REPORT_REC_PROC, REPORT_REC_SUMMARY, REPORT_REC_CORE, REPORT_REC_STATS };
+
+typedef struct {
+    uint32_t type;
+    uint32_t len;           // payload bytes that follow
+} report_rec_t;
+
+typedef struct {
+    int32_t cpu, start, end;
+    int32_t proc;           // index of the REPORT_REC_PROC with that index, -1 = idle
+} report_seg_t;
+
+typedef struct {
+    int32_t index, arrival, burst, start, finish, wait, resp, turn;
+    int32_t pid_len, pad;
+} report_proc_t;
+
+typedef struct {
+    double  mean, stddev;
+    int32_t p50, p95, p99, max;
+} report_dist_t;
+
+typedef struct {
+    int64_t nprocs, migrations;
+    int32_t makespan, ncpus;
+    int32_t max_wait, pid_len;      // pid_len: max-wait PID bytes after the record
+    int32_t peak_live, pad;         // peak_live: streaming runs only, else -1
+    double  avg_wait, avg_resp, avg_turn, throughput, cpu_utilization;
+    report_dist_t wait, resp, turn;
+} report_summary_t;
+
+typedef struct {
+    int32_t cpu, pad;
+    int64_t busy, dispatches, migrations, steals;
+    double  utilization;
+} report_core_t;
+
+typedef struct {
+    int64_t dispatches, context_switches, preemptions, idle_ticks;
+    int64_t decisions, rq_depth_sum, rq_depth_max, rq_dup_rejects, rq_cap_drops;
+    int64_t handoff_waits, handoff_parks, worker_parks;
+    int64_t t_admit, t_pick, t_handoff, t_account, run_clock;   // stats_clock() units
+    double  run_ns;
+} report_stats_t;
+
+// What a report is about, for its heading
+typedef struct {
+    const char *policy;     // label, e.g. "RR"
+    int         ncpus;      // > 1: SMP run
+    const char *queue;      // SMP queue layout ("global" / "per-CPU")
+    bool        streaming;  // rows arrive as processes finish; makespan comes with the summary
+    int         makespan;   // not streaming: shown in the heading
+    int         nprocs;
+} report_info_t;
+
+typedef struct report report_t;
+
+// path NULL or "-" is stdout. NULL if the file can't be created (reported).
+report_t *report_open(output_fmt_t fmt, const char *path, bool timeline, bool rows);
+bool      report_wants_timeline(const report_t *r);
+bool      report_wants_rows(const report_t *r);
+
+void report_begin(report_t *r, const report_info_t *info);
+void report_timeline(report_t *r, int cpu, const tl_seg_t *segs, int nsegs, const proc_table_t *procs);
+void report_row(report_t *r, const proc_table_t *procs, int i, const char *pid, int pid_len);
+void report_rows(report_t *r, const proc_table_t *procs);   // every row, with the table's PIDs
+// max_pid names M->max_wait's proc (NULL if none); peak_live < 0 unless streaming
+void report_summary(report_t *r, const metrics_t *M, int makespan,
+                    const char *max_pid, int max_pid_len, int peak_live);
+void report_stats(report_t *r, const sched_stats_t *s);
+int  report_close(report_t *r);   // 0, or -1 if writing failed (reported)
+
+// The text percentile table, for reports that print their own layout (batch)
+void report_percentiles(outbuf_t *ob, const metrics_t *M);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef RR_SWEEP_H
+#define RR_SWEEP_H
+
+#include "scheduler_wiring.h"
+
+// Round Robin quantum sweep: load the workload once, then simulate RR for
+// every quantum in lo..hi (inclusive, by step) on a thread pool and print
+// avg wait/response/turnaround and context switches per quantum.
+// nthreads <= 0 = one per core. Returns 0 on success.
+int run_rr_sweep(const char *input, int lo, int hi, int step, int nthreads);
+
+// One row of the sweep: RR at quantum over procs, which is only read, so
+// rows can run in parallel. arrivals is arrivals_init's order for procs.
+typedef struct {
+    int    quantum, makespan;
+    long   ctx_switches;
+    double avg_wait, avg_resp, avg_turn;
+} rr_row_t;
+void rr_sweep_row(const proc_table_t *procs, const arrival_cursor_t *arrivals, int quantum, rr_row_t *out);
+
+#endif
@@ -1,97 +1,152 @@
 #include <stdlib.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <string.h>
 #include <pthread.h>
+#include "scheduler_wiring.h"   // gate_t, readyq_t, proc_table_t + rq_* API
 
 
-typedef struct {
-    pthread_mutex_t mu;
-    pthread_cond_t  cv;
-    int             count;  
-} gate_t;
+typedef struct { int key, idx; } arr_key_t;
 
-static inline void gate_init(gate_t *g, int initial){
-    pthread_mutex_init(&g->mu, NULL);
-    pthread_cond_init(&g->cv, NULL);
-    g->count = (initial < 0) ? 0 : initial;
+static int cmp_arr_key(const void *a, const void *b) {
+    const arr_key_t *x = (const arr_key_t*)a, *y = (const arr_key_t*)b;
+    if (x->key != y->key) return (x->key < y->key) ? -1 : 1;
+    return (x->idx < y->idx) ? -1 : (x->idx > y->idx);
 }
-static inline void gate_destroy(gate_t *g){
-    pthread_cond_destroy(&g->cv);
-    pthread_mutex_destroy(&g->mu);
-}
-static inline void gate_post(gate_t *g){
-    pthread_mutex_lock(&g->mu);
-    g->count += 1;
-    pthread_cond_signal(&g->cv);
-    pthread_mutex_unlock(&g->mu);
-}
-static inline void gate_wait(gate_t *g){
-    pthread_mutex_lock(&g->mu);
-    while (g->count == 0) pthread_cond_wait(&g->cv, &g->mu);
-    g->count -= 1;
-    pthread_mutex_unlock(&g->mu);
-}
-
-
-typedef struct { int *idx, cap, head, tail, len; pthread_mutex_t mu; } readyq_t;
 
-typedef struct {
-    char pid[32];
-    int arrival, burst, priority;
-    int remaining, started_time, finish_time, response_time, waiting_time;
-    bool admitted, done;
-    gate_t run_gate;   // was: sem_t run_sem
-} proc_t;
+/* Arrival-ordered index, ties by input order. Everything that arrives at or
+   before tick 0 is admitted together on tick 0 in input order, so those
+   arrivals sort as if they arrived at 0. Built once per run. */
+void arrivals_init(arrival_cursor_t *c, const proc_table_t *procs) {
+    int nprocs = procs->n;
+    arr_key_t *tmp = (arr_key_t*)malloc(sizeof(arr_key_t) * (nprocs > 0 ? nprocs : 1));
+    c->order = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    c->n = nprocs;
+    c->next = 0;
+    for (int i = 0; i < nprocs; ++i) {
+        tmp[i].key = procs->arrival[i] > 0 ? procs->arrival[i] : 0;
+        tmp[i].idx = i;
+    }
+    qsort(tmp, nprocs, sizeof(arr_key_t), cmp_arr_key);
+    for (int i = 0; i < nprocs; ++i) c->order[i] = tmp[i].idx;
+    free(tmp);
+}
 
-void rq_init(readyq_t *q, int capacity);
-void rq_destroy(readyq_t *q);
-bool rq_empty(readyq_t *q);
-void rq_push(readyq_t *q, int proc_index);
-int  rq_pop_fcfs(readyq_t *q);
-int  rq_pop_min_remaining(readyq_t *q, const proc_t *procs);
-int  rq_pop_best_priority(readyq_t *q, const proc_t *procs);
+void arrivals_destroy(arrival_cursor_t *c) {
+    free(c->order); c->order = NULL;
+    c->n = c->next = 0;
+}
 
+/* Arrival tick of the next not-yet-admitted proc, INT_MAX when none are left */
+int arrivals_next_time(const arrival_cursor_t *c, const proc_table_t *procs) {
+    return (c->next < c->n) ? procs->arrival[c->order[c->next]] : INT_MAX;
+}
 
-void admit_arrivals(proc_t *procs, int nprocs, readyq_t *rq, int current_time) {
-    int *to_push = (int*)malloc(sizeof(int) * nprocs);
-    int push_count = 0;
+/* Admit everything that has arrived by current_time: the cursor only moves
+   forward, so each call costs O(new arrivals) and allocates nothing. The
+   batch is order[next - count, next) and goes into the queue in one call.
+   ready_since is the arrival tick even if admission happens later (the event
+   engine admits a whole slice's arrivals at once). */
+int admit_arrivals(policy_t *p, arrival_cursor_t *c, int current_time) {
+    proc_table_t *procs = p->procs;
+    readyq_t *rq = &p->rq;
+    int first = c->next;
 
     pthread_mutex_lock(&rq->mu);
-    for (int i = 0; i < nprocs; ++i) {
-        if (!procs[i].admitted && !procs[i].done && procs[i].arrival <= current_time) {
-            procs[i].admitted = true;         // write under rq->mu (fix #4)
-            to_push[push_count++] = i;        // defer queue mutation until after unlock
-        }
+    while (c->next < c->n && procs->arrival[c->order[c->next]] <= current_time) {
+        int i = c->order[c->next];
+        int a = procs->arrival[i];
+        procs->ready_since[i] = a > 0 ? a : 0;      // write under rq->mu (fix #4)
+        c->next++;
     }
     pthread_mutex_unlock(&rq->mu);
 
-    for (int k = 0; k < push_count; ++k) rq_push(rq, to_push[k]);
-    free(to_push);
+    int count = c->next - first;
+    if (count > 0) policy_arrive(p, &c->order[first], count);
+    return count;
 }
 
-void inc_waiting_all_except(readyq_t *rq, proc_t *procs, int running_idx) {
-    pthread_mutex_lock(&rq->mu);
-    int p = rq->head;
-    for (int k = 0; k < rq->len; ++k, p = (p + 1) % rq->cap) {
-        int i = rq->idx[p];
-        if (i != running_idx) procs[i].waiting_time++; 
+/* Lazy waiting-time accounting. Instead of bumping waiting_time on every
+   queued proc every tick, charge the span a proc sat in the ready queue when it
+   is dispatched. A proc is off the CPU only while queued, so this adds up to
+   exactly the per-tick count. Call once per decision, before running chosen. */
+void charge_waiting(proc_table_t *procs, int running_idx, int chosen, int now) {
+    if (chosen < 0 || chosen == running_idx) return;
+    if (running_idx >= 0) procs->ready_since[running_idx] = now;   // preempted / requeued
+    procs->waiting_time[chosen] += now - procs->ready_since[chosen];
+}
+
+
+/* Append [start, end) on proc to a timeline, merging with the previous
+   segment when it is the same proc and contiguous, so a proc that keeps the
+   CPU for many ticks or slices is still one segment. */
+void seg_emit(seg_buf_t *b, int start, int end, int proc) {
+    if (!b || start >= end) return;
+    if (b->len > 0) {
+        tl_seg_t *last = &b->v[b->len - 1];
+        if (last->proc == proc && last->end == start) { last->end = end; return; }
     }
-    pthread_mutex_unlock(&rq->mu);
+    if (b->len == b->cap) {
+        b->cap = b->cap ? b->cap * 2 : 256;
+        b->v = (tl_seg_t*)realloc(b->v, sizeof(tl_seg_t) * b->cap);
+    }
+    b->v[b->len++] = (tl_seg_t){ start, end, proc };
+}
+
+
+/* Linux's nice-to-weight table: nice 0 is 1024 and each step is ~1.25x */
+static const int nice_weight[40] = {
+    88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,  3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,   335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,    36,    29,    23,    18,    15,
+};
+
+/* CFS weight of a priority, read as a nice value and clamped to -20..19 */
+int cfs_weight(int priority) {
+    if (priority < -20) priority = -20;
+    if (priority > 19)  priority = 19;
+    return nice_weight[priority + 20];
 }
 
+/* Defaults: MLFQ gets three levels whose quanta start at the RR quantum (2
+   without one) and double per level, and a boost every 100 ticks; CFS gets
+   a 24-tick target latency and a 3-tick minimum slice (Linux's 6 ms and
+   0.75 ms at 4 ticks per ms) */
+void sched_params_init(sched_params_t *sp, int quantum) {
+    memset(sp, 0, sizeof *sp);
+    sp->quantum = quantum;
+    sp->mlfq_levels = 3;
+    for (int l = 0; l < MLFQ_MAX_LEVELS; ++l)
+        sp->mlfq_quantum[l] = (l == 0) ? (quantum > 0 ? quantum : 2) : sp->mlfq_quantum[l - 1] * 2;
+    sp->mlfq_boost = 100;
+    sp->cfs_latency = 24;
+    sp->cfs_min_gran = 3;
+}
 
-int pick_next_fcfs(readyq_t *rq, const proc_t *procs, int running_idx) {
+int pick_next_fcfs(readyq_t *rq, const proc_table_t *procs, int running_idx) {
     (void)procs;
     if (running_idx >= 0) return running_idx;
     return rq_pop_fcfs(rq);
 }
 
-int pick_next_sjf(readyq_t *rq, const proc_t *procs, int running_idx) {
+int pick_next_sjf(readyq_t *rq, const proc_table_t *procs, int running_idx) {
     if (running_idx >= 0) return running_idx;
     return rq_pop_min_remaining(rq, procs);
 }
 
-int pick_next_rr(readyq_t *rq, const proc_t *procs, int running_idx, int *rr_budget, int quantum) {
+/* Preempt only for a strictly shorter queued job. Queued jobs' remaining times
+   are fixed and the running job's only shrinks, so only an arrival can change
+   the answer; the O(1) peek at the heap top is all a non-arrival tick costs. */
+int pick_next_srtf(readyq_t *rq, const proc_table_t *procs, int running_idx) {
+    if (running_idx >= 0) {
+        if (rq_min_remaining(rq, procs) >= procs->remaining[running_idx]) return running_idx;
+        rq_push(rq, running_idx);
+    }
+    return rq_pop_min_remaining(rq, procs);
+}
+
+int pick_next_rr(readyq_t *rq, const proc_table_t *procs, int running_idx, int *rr_budget, int quantum) {
     (void)procs;
     if (running_idx < 0 || *rr_budget == 0) {
         if (running_idx >= 0) rq_push(rq, running_idx); // requeue previous
@@ -101,11 +156,74 @@ int pick_next_rr(readyq_t *rq, const proc_t *procs, int running_idx, int *rr_bud
     return running_idx;
 }
 
-int pick_next_priority(readyq_t *rq, const proc_t *procs, int running_idx) {
-    if (running_idx >= 0) rq_push(rq, running_idx);
+/* The running proc re-enters the queue every tick, so under aging it ranks by
+   now: it gives way once a waiter's aged rank is as good as its own. */
+int pick_next_priority(readyq_t *rq, proc_table_t *procs, int running_idx, int now) {
+    if (running_idx >= 0) {
+        procs->ready_since[running_idx] = now;
+        rq_push(rq, running_idx);
+    }
     return rq_pop_best_priority(rq, procs);
 }
 
-void proc_sems_init(proc_t *procs, int n)  { for (int i = 0; i < n; ++i) gate_init(&procs[i].run_gate, 0); }
-void proc_sems_destroy(proc_t *procs, int n){ for (int i = 0; i < n; ++i) gate_destroy(&procs[i].run_gate); }
+/* The running proc keeps the CPU until its quantum is used up (then it drops a
+   level and goes to the back of it) or something is queued on a higher level
+   (then it goes to the back of its own level and gets a fresh quantum when it
+   is next dispatched). *budget is the quantum left. */
+int pick_next_mlfq(readyq_t *rq, proc_table_t *procs, int running_idx, int *budget,
+                   const sched_params_t *sp) {
+    if (running_idx >= 0) {
+        if (*budget == 0) {
+            if (procs->level[running_idx] < sp->mlfq_levels - 1) procs->level[running_idx]++;
+        } else if (rq_top_level(rq) >= procs->level[running_idx]) {
+            return running_idx;
+        }
+        rq_push(rq, running_idx);
+    }
+    int chosen = rq_pop_fcfs(rq);   // head of the best level, sets its level
+    if (chosen >= 0) *budget = sp->mlfq_quantum[procs->level[chosen]];
+    return chosen;
+}
 
+/* First boost tick after now. Boosts fall on multiples of mlfq_boost; the
+   policy's on_clock applies one after that tick's arrivals are admitted and
+   before deciding, and its slices end there so every engine boosts on the
+   same tick. */
+int mlfq_next_boost(const sched_params_t *sp, int now) {
+    if (sp->mlfq_boost <= 0) return INT_MAX;
+    return (now / sp->mlfq_boost + 1) * sp->mlfq_boost;
+}
+
+/* Move every queued proc, and the running one, back to level 0: level 0 keeps
+   its order and the lower levels follow it in turn. The running proc keeps
+   what is left of its quantum. */
+void mlfq_boost(readyq_t *rq, proc_table_t *procs, int running_idx) {
+    rq_boost(rq);
+    if (running_idx >= 0) procs->level[running_idx] = 0;
+}
+
+/* chosen's share of the scheduling period, by weight against everything
+   runnable on this queue (chosen has already been popped) */
+static int cfs_slice(readyq_t *rq, const proc_table_t *procs, int chosen, const sched_params_t *sp) {
+    long long nr = rq_len(rq) + 1;
+    long long w = cfs_weight(procs->priority[chosen]);
+    long long period = sp->cfs_latency;
+    if (nr * sp->cfs_min_gran > period) period = nr * sp->cfs_min_gran;
+    long long slice = period * w / (rq_load(rq) + w);
+    if (slice < sp->cfs_min_gran) slice = sp->cfs_min_gran;
+    return slice > 0 ? (int)slice : 1;
+}
+
+/* Run the least-vruntime proc for its slice, then put it back in the tree.
+   *budget is the slice left; the CFS on_tick hook (cfs_tick in
+   policy.c) advances vruntime and spends it as the proc runs. */
+int pick_next_cfs(readyq_t *rq, proc_table_t *procs, int running_idx, int *budget,
+                  const sched_params_t *sp) {
+    if (running_idx >= 0) {
+        if (*budget > 0) return running_idx;
+        rq_push(rq, running_idx);
+    }
+    int chosen = rq_pop_fcfs(rq);   // leftmost node
+    if (chosen >= 0) *budget = cfs_slice(rq, procs, chosen, sp);
+    return chosen;
+}
\ No newline at end of file
@@ -1,140 +1,287 @@
 #include "scheduler_wiring.h"
+#include "metrics.h"
+#include "stats.h"
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <pthread.h>
+#include <unistd.h>
 
-// Globals for worker access (kept internal to this module)
-static proc_t  *G_PROCS = NULL;
-static int      G_NOW   = 0;
-static gate_t   G_TICK_DONE;   // worker posts at end of its 1-tick slice
-static readyq_t *G_RQ   = NULL; // to lock around procs[] updates in worker
+// Small stacks: a worker body only updates its proc's row
+#define WORKER_STACK (64 * 1024)
+#define SLICE_EXIT (-1)
 
+typedef struct sim_ctx sim_ctx_t;
+
+// A pool thread. proc is the proc bound to it (-1 if free); the scheduler
+// sets it before posting a grant and only the scheduler rebinds it.
+typedef struct {
+    sim_ctx_t *ctx;
+    handoff_t  grant;      // scheduler posts a slice (ticks) or SLICE_EXIT
+    int        proc;
+    pthread_t  th;
+} worker_t;
+
+// Per-run simulation state. Everything a run touches lives here (no file
+// statics), so independent runs can execute concurrently, e.g. in batch mode.
+struct sim_ctx {
+    proc_table_t *procs;
+    int        now;
+    handoff_t  slice_done; // worker posts when its slice has run
+    policy_t   pol;
+    // bounded pool: procs bind to a worker on dispatch, release on completion
+    worker_t  *workers;
+    int        nworkers;
+    int       *worker_of;  // per proc: bound worker, -1 if none
+    int       *free_workers, nfree;
+    int        victim;     // clock hand for evicting a binding when none is free
+};
+
+// The scheduler is parked in handoff_wait while a worker runs, and the
+// handoffs order everything either side writes before posting, so the
+// worker updates its proc without taking any lock.
 static void *worker(void *arg) {
-    int idx = (int)(intptr_t)arg;
-    proc_t *p = &G_PROCS[idx];
+    worker_t *W = (worker_t*)arg;
+    sim_ctx_t *ctx = W->ctx;
+    proc_table_t *P = ctx->procs;
 
     for (;;) {
-        gate_wait(&p->run_gate);  // wait for 1 tick or exit signal
+        int ticks = handoff_wait(&W->grant);   // a slice, or the exit signal
+        if (ticks == SLICE_EXIT) break;
+        int i = W->proc;
 
-        // Check/modify process fields under the ready-queue mutex (race-free)
-        pthread_mutex_lock(&G_RQ->mu);
-
-        if (p->done) { // scheduler signaled exit
-            pthread_mutex_unlock(&G_RQ->mu);
-            break;
+        if (P->started_time[i] < 0) {
+            P->started_time[i] = ctx->now;
+            P->response_time[i] = ctx->now - P->arrival[i];
         }
 
-        if (p->started_time < 0) {
-            p->started_time = G_NOW;
-            p->response_time = G_NOW - p->arrival;
+        P->remaining[i] -= ticks; // consume the whole slice
+
+        // notify scheduler that the slice completed
+        handoff_post(&ctx->slice_done, 1);
+    }
+    return NULL;
+}
+
+// Start up to n pool threads; returns how many started (pthread_create can
+// fail past the process's thread limit, and fewer workers still work)
+static int pool_start(sim_ctx_t *ctx, int n, int nprocs) {
+    int spin = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? HANDOFF_SPIN_MAX : 0;
+    size_t stack = WORKER_STACK;
+#ifdef PTHREAD_STACK_MIN
+    if (stack < (size_t)PTHREAD_STACK_MIN) stack = PTHREAD_STACK_MIN;
+#endif
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, stack);
+
+    ctx->workers = (worker_t*)malloc(sizeof(worker_t) * n);
+    ctx->free_workers = (int*)malloc(sizeof(int) * n);
+    ctx->worker_of = (int*)malloc(sizeof(int) * (nprocs > 0 ? nprocs : 1));
+    for (int i = 0; i < nprocs; ++i) ctx->worker_of[i] = -1;
+
+    int started = 0;
+    for (; started < n; ++started) {
+        worker_t *W = &ctx->workers[started];
+        W->ctx = ctx;
+        W->proc = -1;
+        handoff_init(&W->grant, spin);
+        if (pthread_create(&W->th, &attr, worker, W) != 0) {
+            handoff_destroy(&W->grant);
+            break;
         }
+    }
+    pthread_attr_destroy(&attr);
 
-        p->remaining -= 1; // consume exactly one CPU tick
+    ctx->nworkers = started;
+    ctx->nfree = 0;
+    for (int w = started - 1; w >= 0; --w) ctx->free_workers[ctx->nfree++] = w;
+    ctx->victim = 0;
+    return started;
+}
 
-        pthread_mutex_unlock(&G_RQ->mu);
+// Returns how many times the workers parked waiting for a grant
+static long long pool_stop(sim_ctx_t *ctx) {
+    long long parks = 0;
+    for (int w = 0; w < ctx->nworkers; ++w) handoff_post(&ctx->workers[w].grant, SLICE_EXIT);
+    for (int w = 0; w < ctx->nworkers; ++w) {
+        pthread_join(ctx->workers[w].th, NULL);
+        parks += ctx->workers[w].grant.parks;
+        handoff_destroy(&ctx->workers[w].grant);
+    }
+    free(ctx->workers);
+    free(ctx->free_workers);
+    free(ctx->worker_of);
+    return parks;
+}
 
-        // notify scheduler that the tick completed
-        gate_post(&G_TICK_DONE);
+// Worker that runs proc i: its own if bound, else a free one, else one taken
+// from another (preempted) proc. Procs keep no state on their worker, so a
+// rebinding is only bookkeeping.
+static worker_t *pool_bind(sim_ctx_t *ctx, int i) {
+    int w = ctx->worker_of[i];
+    if (w < 0) {
+        if (ctx->nfree > 0) {
+            w = ctx->free_workers[--ctx->nfree];
+        } else {
+            w = ctx->victim;
+            ctx->victim = (ctx->victim + 1) % ctx->nworkers;
+            ctx->worker_of[ctx->workers[w].proc] = -1;
+        }
+        ctx->workers[w].proc = i;
+        ctx->worker_of[i] = w;
     }
-    return NULL;
+    return &ctx->workers[w];
+}
+
+static void pool_release(sim_ctx_t *ctx, int i) {
+    int w = ctx->worker_of[i];
+    if (w < 0) return;
+    ctx->worker_of[i] = -1;
+    ctx->workers[w].proc = -1;
+    ctx->free_workers[ctx->nfree++] = w;
 }
 
-int run_scheduler(proc_t *procs, int nprocs, scheduler_t alg, int quantum,
-                  int **out_timeline, int *out_tl_len) {
-    // init globals and barrier
-    G_PROCS = procs; G_NOW = 0;
-    gate_init(&G_TICK_DONE, 0);
-
-    // ready queue and per-proc gates
-    readyq_t rq; rq_init(&rq, nprocs * 2);
-    G_RQ = &rq;
-    for (int i=0;i<nprocs;++i) gate_init(&procs[i].run_gate, 0);
-
-    // spawn workers
-    pthread_t *ths = (pthread_t*)malloc(sizeof(pthread_t)*nprocs);
-    for (int i=0;i<nprocs;++i) pthread_create(&ths[i], NULL, worker, (void*)(intptr_t)i);
-
-    // timeline (optional)
-    int *timeline = NULL, tl_cap = 0, tl_len = 0;
-    if (out_timeline && out_tl_len) {
-        tl_cap = 2048;
-        timeline = (int*)malloc(sizeof(int)*tl_cap);
+// Inline equivalent of one worker slice: same field updates, no handoff
+static void run_slice_inline(proc_table_t *P, int i, int now, int ticks) {
+    if (P->started_time[i] < 0) {
+        P->started_time[i] = now;
+        P->response_time[i] = now - P->arrival[i];
     }
+    P->remaining[i] -= ticks;
+}
 
-    int finished = 0, running_idx = -1;
-    int rr_budget = (alg == SCHED_RR ? quantum : 0);
+// Loop shared by both engines. threaded=true hands each slice to the
+// process's pool worker and, like the event engine, makes it as long as the
+// policy allows (policy_slice), idling straight to the next arrival.
+// threaded=false decides every tick and does the worker's update in place,
+// so there are no threads or handoffs at all.
+static int run_tick_loop(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                         int nworkers, metrics_acc_t *acc, sched_stats_t *stats,
+                         tl_seg_t **out_segs, int *out_nsegs, bool threaded) {
+    int nprocs = procs->n;
+    STAT_BEGIN(stats);
 
-    // main loop
-    while (finished < nprocs) {
-        // grow timeline if asked for
-        if (timeline && tl_len >= tl_cap) {
-            tl_cap *= 2;
-            timeline = (int*)realloc(timeline, sizeof(int)*tl_cap);
-        }
+    // per-run context
+    sim_ctx_t ctx = { .procs = procs, .now = 0 };
 
-        admit_arrivals(procs, nprocs, &rq, G_NOW);
+    // policy and its ready queue
+    policy_t *pol = &ctx.pol; policy_init(pol, policy, procs, nprocs, sp);
+    arrival_cursor_t arrivals; arrivals_init(&arrivals, procs);
 
-        int chosen = -1;
-        switch (alg) {
-            case SCHED_NONE:     /* fallthrough, treat as FCFS */
-            case SCHED_FCFS:     chosen = pick_next_fcfs(&rq, procs, running_idx); break;
-            case SCHED_SJF:      chosen = pick_next_sjf (&rq, procs, running_idx); break;
-            case SCHED_RR:       chosen = pick_next_rr  (&rq, procs, running_idx, &rr_budget, quantum); break;
-            case SCHED_PRIORITY: chosen = pick_next_priority(&rq, procs, running_idx); break;
-            default:             chosen = -1; break;
+    // start the pool: never more workers than procs
+    if (threaded) {
+        if (nworkers <= 0) nworkers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if (nworkers > nprocs) nworkers = nprocs;
+        if (nworkers < 1) nworkers = 1;
+        handoff_init(&ctx.slice_done, sysconf(_SC_NPROCESSORS_ONLN) > 1 ? HANDOFF_SPIN_MAX : 0);
+        int started = pool_start(&ctx, nworkers, nprocs);
+        if (started < nworkers)
+            fprintf(stderr, "warning: started %d of %d worker threads%s\n", started, nworkers,
+                    started ? "" : ", falling back to the inline engine");
+        if (started == 0) {
+            pool_stop(&ctx);
+            handoff_destroy(&ctx.slice_done);
+            threaded = false;
         }
+    }
+
+    // timeline (optional), one segment per run of ticks on the same proc
+    seg_buf_t segs = {0};
+    seg_buf_t *tl = (out_segs && out_nsegs) ? &segs : NULL;
+
+    int finished = 0, running_idx = -1, last_ran = -1;
+    int budget = 0;
+    uint64_t lap = STAT_START(stats);
+
+    // main loop
+    while (finished < nprocs) {
+        admit_arrivals(pol, &arrivals, ctx.now);
+        STAT_LAP(stats, t_admit, lap);
+        policy_clock(pol, &running_idx, running_idx >= 0, ctx.now);
 
-        if (timeline) timeline[tl_len++] = chosen;
+        STAT_RQ(stats, pol->rq.len);
+        int chosen = policy_pick(pol, running_idx, ctx.now, &budget);
 
-        if (chosen < 0) {
-            inc_waiting_all_except(&rq, procs, -1); // idle tick
-            G_NOW++;
+        if (chosen < 0) { // idle: one tick, or straight to the next arrival
+            int t = threaded ? arrivals_next_time(&arrivals, procs) : ctx.now + 1;
+            seg_emit(tl, ctx.now, t, -1);
+            STAT_ADD(stats, idle_ticks, t - ctx.now);
+            ctx.now = t;
+            STAT_LAP(stats, t_pick, lap);
             continue;
         }
+        STAT_ADD(stats, dispatches, 1);
+        STAT_ADD(stats, context_switches, last_ran >= 0 && chosen != last_ran);
+        STAT_ADD(stats, preemptions, running_idx >= 0 && chosen != running_idx);
+        last_ran = chosen;
+        STAT_LAP(stats, t_pick, lap);
 
-        inc_waiting_all_except(&rq, procs, chosen);
+        charge_waiting(procs, running_idx, chosen, ctx.now);
+        STAT_LAP(stats, t_account, lap);
 
-        // grant 1 tick and wait for completion
-        gate_post(&procs[chosen].run_gate);
-        gate_wait(&G_TICK_DONE);
+        int slice = threaded
+            ? policy_slice(pol, chosen, budget, arrivals_next_time(&arrivals, procs), ctx.now)
+            : procs->remaining[chosen] > 0;   // one tick, or none (see policy_slice)
+        STAT_LAP(stats, t_pick, lap);
+        seg_emit(tl, ctx.now, ctx.now + slice, chosen);
+        STAT_LAP(stats, t_account, lap);
 
-        // completion check and state updates under rq.mu (rq is a stack var → use dot)
-        pthread_mutex_lock(&rq.mu);
-        int now_remaining = procs[chosen].remaining;
-        bool was_done = procs[chosen].done;
+        // grant the slice and wait for completion; a zero slice (nothing left to
+        // run) can't be posted, since 0 is the empty slot, and needs no worker
+        if (threaded && slice > 0) {
+            handoff_post(&pool_bind(&ctx, chosen)->grant, slice);
+            handoff_wait(&ctx.slice_done);
+            STAT_ADD(stats, handoff_waits, 1);
+        } else {
+            run_slice_inline(procs, chosen, ctx.now, slice);
+        }
+        ctx.now += slice;
+        STAT_LAP(stats, t_handoff, lap);
 
-        if (now_remaining == 0 && !was_done) {
-            procs[chosen].done = true;
-            procs[chosen].finish_time = G_NOW + 1;
+        if (procs->remaining[chosen] <= 0) {
+            procs->done[chosen] = true;
+            procs->finish_time[chosen] = ctx.now;
             finished++;
             running_idx = -1;
-            if (alg == SCHED_RR) rr_budget = quantum;
-            pthread_mutex_unlock(&rq.mu);
-
-            // wake worker once more so it can observe done=true and exit
-            gate_post(&procs[chosen].run_gate);
+            policy_complete(pol, chosen);
+            if (acc) macc_complete(acc, procs, chosen);
+            if (threaded) pool_release(&ctx, chosen);
         } else {
             running_idx = chosen;
-            if (alg == SCHED_RR) rr_budget--;
-            pthread_mutex_unlock(&rq.mu);
+            policy_tick(pol, chosen, slice, &budget);
         }
-
-        G_NOW++;
+        STAT_LAP(stats, t_account, lap);
     }
 
     // join & cleanup
-    for (int i=0;i<nprocs;++i) pthread_join(ths[i], NULL);
-    free(ths);
-    for (int i=0;i<nprocs;++i) gate_destroy(&procs[i].run_gate);
-    gate_destroy(&G_TICK_DONE);
-    rq_destroy(&rq);
-
-    if (out_timeline && out_tl_len) {
-        *out_timeline = timeline;
-        *out_tl_len = tl_len;
-    } else if (timeline) {
-        free(timeline);
+    if (threaded) {
+        long long worker_parks = pool_stop(&ctx);
+        STAT_ADD(stats, worker_parks, worker_parks);
+        STAT_ADD(stats, handoff_parks, ctx.slice_done.parks);
+        handoff_destroy(&ctx.slice_done);
+    }
+    STAT_QUEUE(stats, &pol->rq);
+    STAT_END(stats);
+    policy_destroy(pol);
+    arrivals_destroy(&arrivals);
+
+    if (tl) {
+        *out_segs = segs.v;
+        *out_nsegs = segs.len;
     }
 
-    return G_NOW; // makespan
+    return ctx.now; // makespan
+}
+
+int run_scheduler(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                  int nworkers, metrics_acc_t *acc, sched_stats_t *stats,
+                  tl_seg_t **out_segs, int *out_nsegs) {
+    return run_tick_loop(procs, policy, sp, nworkers, acc, stats, out_segs, out_nsegs, true);
+}
+
+int run_scheduler_inline(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                         metrics_acc_t *acc, sched_stats_t *stats, tl_seg_t **out_segs, int *out_nsegs) {
+    return run_tick_loop(procs, policy, sp, 0, acc, stats, out_segs, out_nsegs, false);
 }
@@ -1,6 +1,9 @@
 #pragma once
+#include <assert.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Avoid POSIX macro collisions with our enum labels in cmdparser.h */
 #ifdef SCHED_RR
@@ -13,7 +16,7 @@
 #undef SCHED_OTHER
 #endif
 
-#include "cmdparser.h"   // provides scheduler_t (SCHED_NONE/FCFS/SJF/RR/PRIORITY)
+#include "cmdparser.h"   // engine_t, rq_policy_t, balance_t, MLFQ_MAX_LEVELS
 
 /* ---- portable gate (replaces unnamed POSIX semaphores) ---- */
 typedef struct {
@@ -43,38 +46,402 @@ static inline void gate_wait(gate_t *g){
     g->count -= 1;
     pthread_mutex_unlock(&g->mu);
 }
+/* ---- single-producer / single-consumer handoff ----
+   A one-slot mailbox for a nonzero int. post publishes with one atomic
+   store and only touches the mutex when the consumer has parked; wait spins
+   on the slot for a while before parking on the condvar. The spin budget
+   adapts between 0 and spin_max: it grows when spinning caught the post and
+   shrinks when the consumer had to park, so a thread that waits long stops
+   burning a core. Pass spin_max 0 on a single CPU, where the poster cannot
+   run while the consumer spins. Posting to a full slot is not allowed (one
+   message in flight). */
+#if defined(__x86_64__) || defined(__i386__)
+#define cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+#define cpu_relax() __asm__ __volatile__("yield")
+#else
+#define cpu_relax() ((void)0)
+#endif
+
+#define HANDOFF_SPIN_MIN 16
+#define HANDOFF_SPIN_MAX 16384
+
+typedef struct {
+    atomic_int      value;    // 0 = empty
+    atomic_int      parked;   // consumer is asleep (or about to be) on cv
+    int             spin;     // consumer's current spin budget
+    int             spin_max;
+    long long       parks;    // waits that gave up spinning for the mutex/cv path
+    pthread_mutex_t mu;
+    pthread_cond_t  cv;
+} handoff_t;
+
+static inline void handoff_init(handoff_t *h, int spin_max){
+    atomic_init(&h->value, 0);
+    atomic_init(&h->parked, 0);
+    h->parks = 0;
+    h->spin_max = spin_max;
+    h->spin = spin_max < HANDOFF_SPIN_MIN ? spin_max : HANDOFF_SPIN_MIN;
+    pthread_mutex_init(&h->mu, NULL);
+    pthread_cond_init(&h->cv, NULL);
+}
+static inline void handoff_destroy(handoff_t *h){
+    pthread_cond_destroy(&h->cv);
+    pthread_mutex_destroy(&h->mu);
+}
+/* seq_cst store then load, against the consumer's store to parked then load
+   of value: at least one side sees the other, so a post is never lost */
+static inline void handoff_post(handoff_t *h, int v){
+    assert(v != 0);   // 0 is the empty slot: the consumer would never wake
+    atomic_store(&h->value, v);
+    if (atomic_load(&h->parked)) {
+        pthread_mutex_lock(&h->mu);
+        pthread_cond_signal(&h->cv);
+        pthread_mutex_unlock(&h->mu);
+    }
+}
+static inline int handoff_wait(handoff_t *h){
+    int v;
+    for (int k = 0; k < h->spin; ++k) {
+        if (atomic_load_explicit(&h->value, memory_order_relaxed) &&
+            (v = atomic_exchange(&h->value, 0))) {
+            if (h->spin * 2 <= h->spin_max) h->spin *= 2;
+            return v;
+        }
+        cpu_relax();
+    }
+    if (h->spin > HANDOFF_SPIN_MIN) h->spin /= 2;
+    h->parks++;
+    pthread_mutex_lock(&h->mu);
+    atomic_store(&h->parked, 1);
+    while ((v = atomic_exchange(&h->value, 0)) == 0) pthread_cond_wait(&h->cv, &h->mu);
+    atomic_store(&h->parked, 0);
+    pthread_mutex_unlock(&h->mu);
+    return v;
+}
 /* ----------------------------------------------------------- */
 
 /* Shared structs */
+
+/* Process table, structure of arrays: one array per field, indexed by proc.
+   The scheduler core scans one field across many procs (remaining for SJF,
+   priority for PRIORITY, arrival for admission), so each scan streams a
+   dense int array instead of striding over whole records. PIDs and result
+   timings are cold: only the output code reads them. */
+typedef struct {
+    int   n, cap;
+    /* inputs; may point into a copy-on-write trace mapping (see trace.h) */
+    int  *arrival, *burst, *priority;
+    /* hot run state */
+    int  *remaining;
+    int  *ready_since;   // tick it last entered the ready queue (lazy waiting_time)
+    int  *level;         // MLFQ queue level, 0 = top
+    int64_t *vruntime;   // CFS virtual runtime, weighted by priority
+    /* results */
+    int  *started_time, *finish_time, *response_time, *waiting_time;
+    bool *done;
+    /* PIDs: proc i is pid_str[pid_off[k] .. pid_off[k + 1]), not NUL-terminated,
+       where k = pid_id[i], or k = i when pid_id is NULL */
+    uint32_t *pid_id, *pid_off;
+    char     *pid_str;
+    size_t    pid_len, pid_cap;   // bytes used / allocated in pid_str
+    void     *map;                // backing trace mapping, if any
+    size_t    map_len;
+} proc_table_t;
+
+static inline const char *pt_pid(const proc_table_t *t, int i) {
+    return t->pid_str + t->pid_off[t->pid_id ? t->pid_id[i] : (uint32_t)i];
+}
+static inline int pt_pid_len(const proc_table_t *t, int i) {
+    uint32_t k = t->pid_id ? t->pid_id[i] : (uint32_t)i;
+    return (int)(t->pid_off[k + 1] - t->pid_off[k]);
+}
+
+/* proc_table.c */
+void pt_init(proc_table_t *t);
+void pt_reserve(proc_table_t *t, int cap);   // run-state columns; inputs + PIDs too unless mapped
+int  pt_append(proc_table_t *t, const char *pid, int pid_len,
+               int arrival, int burst, int priority);   // returns the new proc's index
+void pt_reset(proc_table_t *t);              // per-run fields, before every run
+void pt_free(proc_table_t *t);
+
+/* Ready-queue backend: FIFO ring (FCFS/RR), indexed min-heap (SJF/PRIORITY),
+   one FIFO list per level (MLFQ) or a red-black tree on vruntime (CFS) */
+typedef enum { RQ_FIFO, RQ_HEAP, RQ_LEVELS, RQ_TREE } rq_kind_t;
+typedef enum { RQ_KEY_REMAINING, RQ_KEY_PRIORITY, RQ_KEY_AGED } rq_key_t;
+
 typedef struct {
-    int *idx, cap, head, tail, len;
+    int *idx, cap, head, tail, len;   // FIFO: ring [head, tail); HEAP: idx[0..len)
     pthread_mutex_t mu;
+    uint64_t *member;                 // RQ_FIFO: bit per proc, set while queued
+    long long dup_rejects;            // pushes of a proc already queued (ignored)
+    long long cap_drops;              // pushes of an index >= cap (dropped)
+
+    /* RQ_HEAP only: min-heap on (key, seq); seq is the enqueue order, so ties
+       resolve exactly like the linear scan over the FIFO ring did */
+    rq_kind_t kind;
+    rq_key_t  key;
+    const proc_table_t *procs;    // where push reads the key from
+    int       age_ticks;          // RQ_KEY_AGED: key = priority + ready_since / age_ticks
+    int      *pos;                // pos[proc] = heap slot, -1 if not queued
+    int      *hkey;               // hkey[proc] = key captured at push / last update
+    unsigned *hseq;               // hseq[proc] = enqueue sequence number
+    unsigned  next_seq;
+
+    /* RQ_LEVELS only: doubly linked FIFO per level through lnext/lprev, -1
+       terminated. push reads procs->level; pop and steal write it back, since
+       a boost moves whole lists without touching their procs. */
+    int  lhead[MLFQ_MAX_LEVELS], ltail[MLFQ_MAX_LEVELS];
+    int *lnext, *lprev;
+
+    /* RQ_TREE only: red-black tree ordered by (procs->vruntime, hseq). Node k
+       is proc k - 1; node 0 is the shared black leaf. Push places a proc
+       below min_vruntime at min_vruntime, so new arrivals start level with
+       the queue instead of far ahead of it. */
+    int     *rb_left, *rb_right, *rb_parent;
+    uint8_t *rb_red;
+    int      rb_root, rb_first;   // root and cached leftmost node, 0 if empty
+    int64_t  min_vruntime;        // vruntime of the last proc popped, never decreases
+    long long load;               // sum of queued procs' CFS weights
 } readyq_t;
 
+/* Arrival-ordered admission cursor (sched_core.c) */
+typedef struct {
+    int *order;   // proc indices sorted by arrival, ties in input order
+    int  n, next; // order[next] is the next proc to admit
+} arrival_cursor_t;
+
+/* Run-length timeline segment: proc ran over [start, end); proc < 0 = IDLE */
 typedef struct {
-    char pid[32];
-    int arrival, burst, priority;
-    int remaining, started_time, finish_time, response_time, waiting_time;
-    bool admitted, done;
-    gate_t run_gate;   // was: sem_t run_sem
-} proc_t;
+    int start, end, proc;
+} tl_seg_t;
+
+/* Growable segment list the engines append to as they dispatch */
+typedef struct {
+    tl_seg_t *v;
+    int len, cap;
+} seg_buf_t;
+
+/* Per-run policy parameters.
+
+   PRIORITY aging is time-bucketed: a proc queued since tick r ranks as
+   priority + r / aging, i.e. one priority step better for every multiple of
+   aging ticks the clock passes while it waits. The rank is fixed while it
+   waits, so aging needs no rescans or heap updates.
+
+   MLFQ runs the top non-empty level first, FIFO within a level. A proc enters
+   at level 0, drops a level each time it uses up its level's whole quantum,
+   and is preempted by anything queued above it. Every mlfq_boost ticks all
+   procs return to level 0 so CPU-bound work cannot starve.
+
+   CFS runs the proc with the least vruntime for a slice of the period (the
+   target latency, stretched to nr_running x min granularity when crowded) in
+   proportion to its weight; priority is read as a nice value (-20..19). A
+   running proc is only switched out when its slice ends. */
+typedef struct sched_params {
+    int quantum;                         // RR time quantum
+    int mlfq_levels;                     // 1..MLFQ_MAX_LEVELS
+    int mlfq_quantum[MLFQ_MAX_LEVELS];   // per level, top first
+    int mlfq_boost;                      // ticks between boosts, 0 = never
+    int aging;                           // PRIORITY: ticks per priority step, 0 = off
+    int cfs_latency;                     // CFS: period every runnable proc runs once in
+    int cfs_min_gran;                    // CFS: shortest slice
+} sched_params_t;
 
 /* Core ready-queue / scheduler API */
-void rq_init(readyq_t *q, int capacity);
+void rq_init(readyq_t *q, int nprocs);
+void rq_init_heap(readyq_t *q, int nprocs, const proc_table_t *procs, rq_key_t key);
+void rq_init_levels(readyq_t *q, int nprocs, const proc_table_t *procs);
+void rq_init_tree(readyq_t *q, int nprocs, const proc_table_t *procs);
+void rq_reserve(readyq_t *q, int nprocs, const proc_table_t *procs);
 void rq_destroy(readyq_t *q);
 bool rq_empty(readyq_t *q);
+int  rq_len(readyq_t *q);
 void rq_push(readyq_t *q, int proc_index);
+void rq_push_bulk(readyq_t *q, const int *proc_indices, int n);
 int  rq_pop_fcfs(readyq_t *q);
-int  rq_pop_min_remaining(readyq_t *q, const proc_t *procs);
-int  rq_pop_best_priority(readyq_t *q, const proc_t *procs);
-
-void admit_arrivals(proc_t *procs, int nprocs, readyq_t *rq, int current_time);
-void inc_waiting_all_except(readyq_t *rq, proc_t *procs, int running_idx);
-int  pick_next_fcfs(readyq_t *rq, const proc_t *procs, int running_idx);
-int  pick_next_sjf (readyq_t *rq, const proc_t *procs, int running_idx);
-int  pick_next_rr  (readyq_t *rq, const proc_t *procs, int running_idx, int *rr_budget, int quantum);
-int  pick_next_priority(readyq_t *rq, const proc_t *procs, int running_idx);
-
-/* Main entry */
-int run_scheduler(proc_t *procs, int nprocs, scheduler_t alg, int quantum,
-                  int **out_timeline, int *out_tl_len);
\ No newline at end of file
+int  rq_pop_min_remaining(readyq_t *q, const proc_table_t *procs);
+int  rq_pop_best_priority(readyq_t *q, const proc_table_t *procs);
+int  rq_min_priority(readyq_t *q, const proc_table_t *procs);   // aged key with RQ_KEY_AGED
+int  rq_min_remaining(readyq_t *q, const proc_table_t *procs);
+int  rq_top_level(readyq_t *q);   // RQ_LEVELS: best non-empty level, INT_MAX if empty
+void rq_boost(readyq_t *q);       // RQ_LEVELS: every queued proc to level 0
+long long rq_load(readyq_t *q);   // RQ_TREE: total weight queued
+int  rq_steal(readyq_t *q);   // remove from the back, for load balancing
+
+void arrivals_init(arrival_cursor_t *c, const proc_table_t *procs);
+void arrivals_destroy(arrival_cursor_t *c);
+int  arrivals_next_time(const arrival_cursor_t *c, const proc_table_t *procs);
+void charge_waiting(proc_table_t *procs, int running_idx, int chosen, int now);
+int  cfs_weight(int priority);
+void sched_params_init(sched_params_t *sp, int quantum);   // defaults for every policy
+int  pick_next_fcfs(readyq_t *rq, const proc_table_t *procs, int running_idx);
+int  pick_next_sjf (readyq_t *rq, const proc_table_t *procs, int running_idx);
+int  pick_next_rr  (readyq_t *rq, const proc_table_t *procs, int running_idx, int *rr_budget, int quantum);
+int  pick_next_srtf(readyq_t *rq, const proc_table_t *procs, int running_idx);
+int  pick_next_priority(readyq_t *rq, proc_table_t *procs, int running_idx, int now);
+int  pick_next_mlfq(readyq_t *rq, proc_table_t *procs, int running_idx, int *budget,
+                    const sched_params_t *sp);
+int  pick_next_cfs(readyq_t *rq, proc_table_t *procs, int running_idx, int *budget,
+                   const sched_params_t *sp);
+int  mlfq_next_boost(const sched_params_t *sp, int now);   // INT_MAX if boosting is off
+void mlfq_boost(readyq_t *rq, proc_table_t *procs, int running_idx);
+void seg_emit(seg_buf_t *b, int start, int end, int proc);   // b may be NULL
+
+/* Scheduling policies. A policy is an ops table; every engine drives it
+   through a policy_t instance (one per ready queue) and knows nothing else
+   about it. The instance owns its ready queue: init picks the backend
+   (FIFO ring, heap, level lists or tree) and may hang private state off
+   p->state. Built-in policies go through exactly the same calls as ones
+   registered at run time.
+
+   Per decision an engine calls, in order: on_arrival for what was admitted,
+   on_clock, then pick_next, and once the chosen proc has run, on_tick for
+   the ticks it got and on_complete if it finished. *budget is per CPU slice
+   state the engine keeps for the policy (quantum or CFS slice left); it
+   starts at 0 and the policy sets it when it dispatches. */
+typedef struct policy policy_t;
+typedef struct policy_ops {
+    const char *name;      // registry / command-line name, e.g. "rr"
+    const char *label;     // report heading, e.g. "RR"
+    bool needs_quantum;    // reads --quantum and cannot run without it
+    bool uses_aging;       // reads --aging
+
+    /* Required: set up p->rq for procs [0, nprocs). With --stream the table
+       grows later and the engine grows p->rq with rq_reserve. */
+    void (*init)(policy_t *p, int nprocs);
+    void (*destroy)(policy_t *p);                       // optional: free p->state
+    /* Optional: queue n newly admitted procs; default rq_push_bulk */
+    void (*on_arrival)(policy_t *p, const int *ids, int n);
+    /* Optional: time-driven work once the clock reaches now, before any
+       decision; running[] are the procs on CPUs fed from this queue */
+    void (*on_clock)(policy_t *p, const int *running, int nrunning, int now);
+    /* Required: proc to run from now, or -1 for idle; running is the proc
+       that ran up to now (-1 if none) and is requeued here if not chosen */
+    int  (*pick_next)(policy_t *p, int running, int now, int *budget);
+    /* Event engines: ticks chosen can run from now before pick_next could
+       choose differently; next_arrival is INT_MAX when none are left.
+       Optional; without it the event engines decide every tick. */
+    int  (*slice)(policy_t *p, int chosen, int budget, int next_arrival, int now);
+    /* Optional: running ran for ticks more ticks (not finishing) */
+    void (*on_tick)(policy_t *p, int running, int ticks, int *budget);
+    void (*on_complete)(policy_t *p, int proc);         // optional
+} policy_ops_t;
+
+struct policy {
+    const policy_ops_t   *ops;
+    readyq_t              rq;
+    proc_table_t         *procs;
+    const sched_params_t *sp;
+    void                 *state;   // policy-private
+};
+
+/* policy.c: instances and the name registry. The built-ins are registered
+   from the start; policy_register adds more (before any run starts). */
+void policy_init(policy_t *p, const policy_ops_t *ops, proc_table_t *procs, int nprocs,
+                 const sched_params_t *sp);
+void policy_destroy(policy_t *p);
+int  policy_register(const policy_ops_t *ops);   // 0, or -1 if the name is taken or the registry full
+const policy_ops_t *policy_find(const char *name);   // case-insensitive, NULL if unknown
+int  policy_count(void);
+const policy_ops_t *policy_at(int k);
+
+/* Admit everything arrived by current_time into p (sched_core.c) */
+int  admit_arrivals(policy_t *p, arrival_cursor_t *c, int current_time);
+
+static inline void policy_arrive(policy_t *p, const int *ids, int n) {
+    if (p->ops->on_arrival) p->ops->on_arrival(p, ids, n);
+    else rq_push_bulk(&p->rq, ids, n);
+}
+static inline void policy_clock(policy_t *p, const int *running, int nrunning, int now) {
+    if (p->ops->on_clock) p->ops->on_clock(p, running, nrunning, now);
+}
+static inline int policy_pick(policy_t *p, int running, int now, int *budget) {
+    return p->ops->pick_next(p, running, now, budget);
+}
+/* A proc with nothing left to run (burst <= 0) gets a zero slice in every
+   engine: it completes the moment it is dispatched and takes no CPU time */
+static inline int policy_slice(policy_t *p, int chosen, int budget, int next_arrival, int now) {
+    if (p->procs->remaining[chosen] <= 0) return 0;
+    return p->ops->slice ? p->ops->slice(p, chosen, budget, next_arrival, now) : 1;
+}
+static inline void policy_tick(policy_t *p, int running, int ticks, int *budget) {
+    if (p->ops->on_tick) p->ops->on_tick(p, running, ticks, budget);
+}
+static inline void policy_complete(policy_t *p, int proc) {
+    if (p->ops->on_complete) p->ops->on_complete(p, proc);
+}
+
+typedef struct metrics_acc metrics_acc_t;   // metrics.h
+typedef struct sched_stats sched_stats_t;   // stats.h
+
+/* Main entry. Every engine returns the makespan and, if out_segs is given, the
+   timeline as run-length segments (one per dispatch run, IDLE included), so
+   its size follows context switches rather than makespan. If acc is given
+   (metrics.h; macc_init it first), each completion is fed into it as it
+   happens. If stats is given (stats.h), the engine resets it and counts and
+   times the run into it; a build without SCHED_STATS
+   leaves it untouched.
+   run_scheduler runs process bodies on a pool of nworkers threads (<= 0: one
+   per core, never more than procs) with small stacks. A proc binds to a
+   worker when first dispatched and keeps it until it completes, unless every
+   worker is bound and one has to be taken from a preempted proc. Each
+   dispatch hands the worker a whole slice (up to the next scheduling event)
+   through a handoff_t. */
+int run_scheduler(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                  int nworkers, metrics_acc_t *acc, sched_stats_t *stats,
+                  tl_seg_t **out_segs, int *out_nsegs);
+
+/* Same outputs as run_scheduler, but single-threaded and one decision per
+   tick: no worker threads or handoffs, the scheduler applies each tick
+   itself. The tick-by-tick reference the slice-based engines must match. */
+int run_scheduler_inline(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                         metrics_acc_t *acc, sched_stats_t *stats, tl_seg_t **out_segs, int *out_nsegs);
+
+/* Event-driven engine (event_engine.c): same policies and per-process results
+   as run_scheduler, but jumps straight from one scheduling event to the next
+   (arrival, completion, quantum expiry). */
+int run_scheduler_events(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                         metrics_acc_t *acc, sched_stats_t *stats, tl_seg_t **out_segs, int *out_nsegs);
+
+/* One dispatch of the event engine, shared with run_stream (stream.c), which
+   admits from its reader instead of an arrival_cursor_t. The caller admits
+   what has arrived by now, then calls ev_dispatch with the next arrival time
+   (INT_MAX if none): it runs on_clock and pick_next, charges waiting time,
+   runs the chosen proc's slice and advances now past it. Returns the proc
+   that ran, with done, finish_time and on_complete applied if it finished,
+   or -1 if nothing was ready (now is then the caller's to move). */
+typedef struct {
+    policy_t      *pol;
+    int            now, running_idx, last_ran, budget;
+    seg_buf_t     *tl;      // timeline, or NULL
+    sched_stats_t *stats;   // or NULL
+    uint64_t       lap;     // STAT_LAP clock
+} ev_state_t;
+
+int ev_dispatch(ev_state_t *s, int next_arrival);
+
+/* SMP engine (smp_engine.c): the event engine generalised to ncpus CPUs, each
+   dispatching with the same policies from its own queue (RQ_POLICY_PERCPU) or
+   from one shared queue (RQ_POLICY_GLOBAL). ncpus = 1 gives exactly the event
+   engine's results. */
+typedef struct {
+    int         ncpus;
+    rq_policy_t rq_policy;
+    balance_t   balance;            // per-CPU queues only
+    int         balance_interval;   // ticks between BALANCE_PERIODIC passes
+} smp_config_t;
+
+typedef struct {
+    long      busy;         // ticks spent running procs
+    long      dispatches;   // a proc was put on this CPU (not counting continuing slices)
+    long      migrations;   // dispatches of a proc that last ran on another CPU
+    long      steals;       // procs pulled into this CPU's queue by load balancing
+    tl_seg_t *segs;         // this CPU's Gantt lane, if requested (caller frees)
+    int       nsegs;
+} cpu_stats_t;
+
+/* cpus[] has cfg->ncpus entries and is filled in; returns the makespan */
+int run_scheduler_smp(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                      metrics_acc_t *acc, sched_stats_t *stats, const smp_config_t *cfg,
+                      cpu_stats_t *cpus, bool want_timeline);
@@ -0,0 +1,223 @@
+// smp_engine.c — event-driven simulation of several CPUs.
+//
+// Same structure as the single-CPU event engine: at each event time every CPU
+// whose slice is over (or that is idle) makes one pick_next decision and gets
+// a slice from event_slice; the clock then jumps to the earliest slice end,
+// arrival (only while some CPU is idle) or periodic balance pass, and every
+// running CPU is charged the elapsed time. A CPU stopped mid-slice simply
+// keeps going, so with one CPU the schedule is exactly the event engine's.
+#include "scheduler_wiring.h"
+#include "metrics.h"
+#include "stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+typedef struct {
+    int running;     // proc on this CPU, -1 idle
+    int budget;      // RR / MLFQ quantum or CFS slice left
+    int slice_end;   // tick the current slice ends
+    int last;        // last proc to run here, -1 if none (stats only)
+} cpu_t;
+
+typedef struct {
+    const smp_config_t *cfg;
+    policy_t *pols;  // ncpus queues, or one shared queue
+    int       nq;
+    cpu_t    *cpu;
+    int      *running;   // scratch: procs on the CPUs a queue feeds
+    cpu_stats_t *stats;
+} smp_t;
+
+static policy_t *pol_of(smp_t *S, int c) {
+    return &S->pols[S->nq == 1 ? 0 : c];
+}
+
+// Queued plus running procs on c's queue
+static int cpu_load(smp_t *S, int c) {
+    return rq_len(&S->pols[c].rq) + (S->cpu[c].running >= 0);
+}
+
+// Per-CPU placement of a new arrival: least loaded CPU, ties to the lowest id
+static int place(smp_t *S) {
+    int best = 0, best_load = INT_MAX;
+    for (int c = 0; c < S->cfg->ncpus; ++c) {
+        int load = cpu_load(S, c);
+        if (load < best_load) { best_load = load; best = c; }
+    }
+    return best;
+}
+
+// Idle balancing: an empty CPU takes one proc from the longest other queue
+static void steal_into(smp_t *S, int c) {
+    int src = -1, src_len = 0;
+    for (int k = 0; k < S->cfg->ncpus; ++k) {
+        int len = rq_len(&S->pols[k].rq);
+        if (k != c && len > src_len) { src_len = len; src = k; }
+    }
+    if (src < 0) return;
+    int i = rq_steal(&S->pols[src].rq);
+    if (i < 0) return;
+    rq_push(&S->pols[c].rq, i);
+    S->stats[c].steals++;
+}
+
+// Periodic balancing: move procs from the most to the least loaded CPU until
+// their loads differ by at most one. A CPU whose whole load is its running
+// proc has nothing to give, so the source is the most loaded CPU with a
+// non-empty queue.
+static void balance_queues(smp_t *S) {
+    for (;;) {
+        int hi = -1, lo = 0;
+        for (int c = 0; c < S->cfg->ncpus; ++c) {
+            if (rq_len(&S->pols[c].rq) > 0 && (hi < 0 || cpu_load(S, c) > cpu_load(S, hi))) hi = c;
+            if (cpu_load(S, c) < cpu_load(S, lo)) lo = c;
+        }
+        if (hi < 0 || cpu_load(S, hi) - cpu_load(S, lo) <= 1) return;
+        int i = rq_steal(&S->pols[hi].rq);
+        if (i < 0) return;
+        rq_push(&S->pols[lo].rq, i);
+        S->stats[lo].steals++;
+    }
+}
+
+int run_scheduler_smp(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                      metrics_acc_t *acc, sched_stats_t *stats, const smp_config_t *cfg,
+                      cpu_stats_t *cpus, bool want_timeline) {
+    int n = procs->n, ncpus = cfg->ncpus;
+    STAT_BEGIN(stats);
+    smp_t S = { .cfg = cfg, .stats = cpus };
+    S.nq  = (cfg->rq_policy == RQ_POLICY_GLOBAL) ? 1 : ncpus;
+    S.pols = (policy_t*)malloc(sizeof(policy_t) * S.nq);
+    for (int q = 0; q < S.nq; ++q) policy_init(&S.pols[q], policy, procs, n, sp);
+    S.cpu = (cpu_t*)malloc(sizeof(cpu_t) * ncpus);
+    for (int c = 0; c < ncpus; ++c) S.cpu[c] = (cpu_t){ -1, 0, 0, -1 };
+    S.running = (int*)malloc(sizeof(int) * ncpus);
+    memset(cpus, 0, sizeof(cpu_stats_t) * ncpus);
+
+    seg_buf_t *lanes = want_timeline ? (seg_buf_t*)calloc(ncpus, sizeof(seg_buf_t)) : NULL;
+    int *last_cpu = (int*)malloc(sizeof(int) * (n > 0 ? n : 1));
+    for (int i = 0; i < n; ++i) last_cpu[i] = -1;
+
+    arrival_cursor_t arrivals; arrivals_init(&arrivals, procs);
+
+    bool balancing = (S.nq > 1);
+    bool periodic  = balancing && cfg->balance == BALANCE_PERIODIC && cfg->balance_interval > 0;
+    int  next_balance = periodic ? cfg->balance_interval : INT_MAX;
+    int  now = 0, finished = 0;
+    uint64_t lap = STAT_START(stats);
+
+    while (finished < n) {
+        // admit arrivals: shared queue, or the least loaded CPU's queue
+        if (S.nq == 1) {
+            admit_arrivals(&S.pols[0], &arrivals, now);
+        } else {
+            while (arrivals.next < arrivals.n && procs->arrival[arrivals.order[arrivals.next]] <= now) {
+                int i = arrivals.order[arrivals.next++];
+                procs->ready_since[i] = procs->arrival[i] > 0 ? procs->arrival[i] : 0;
+                policy_arrive(&S.pols[place(&S)], &i, 1);
+            }
+        }
+        STAT_LAP(stats, t_admit, lap);
+
+        // the clock reaches every queue, with the procs on the CPUs it feeds
+        if (S.nq == 1) {
+            int nr = 0;
+            for (int c = 0; c < ncpus; ++c) if (S.cpu[c].running >= 0) S.running[nr++] = S.cpu[c].running;
+            policy_clock(&S.pols[0], S.running, nr, now);
+        } else {
+            for (int c = 0; c < ncpus; ++c)
+                policy_clock(&S.pols[c], &S.cpu[c].running, S.cpu[c].running >= 0, now);
+        }
+
+        if (periodic && now >= next_balance) {
+            balance_queues(&S);
+            next_balance = (now / cfg->balance_interval + 1) * cfg->balance_interval;
+        }
+
+        // every CPU at the end of its slice (or idle) decides
+        int next_arrival = arrivals_next_time(&arrivals, procs);
+        for (int c = 0; c < ncpus; ++c) {
+            cpu_t *C = &S.cpu[c];
+            if (C->running >= 0 && C->slice_end > now) continue;
+
+            policy_t *pol = pol_of(&S, c);
+            if (balancing && cfg->balance == BALANCE_IDLE && C->running < 0 && rq_empty(&pol->rq))
+                steal_into(&S, c);
+
+            STAT_RQ(stats, pol->rq.len);
+            int chosen = policy_pick(pol, C->running, now, &C->budget);
+            if (chosen < 0) { C->running = -1; continue; }
+            STAT_ADD(stats, dispatches, 1);
+            STAT_ADD(stats, context_switches, C->last >= 0 && chosen != C->last);
+            STAT_ADD(stats, preemptions, C->running >= 0 && chosen != C->running);
+            C->last = chosen;
+
+            charge_waiting(procs, C->running, chosen, now);
+            if (chosen != C->running) {
+                cpus[c].dispatches++;
+                if (last_cpu[chosen] >= 0 && last_cpu[chosen] != c) cpus[c].migrations++;
+                last_cpu[chosen] = c;
+            }
+            if (procs->started_time[chosen] < 0) {
+                procs->started_time[chosen] = now;
+                procs->response_time[chosen] = now - procs->arrival[chosen];
+            }
+            C->running = chosen;
+            C->slice_end = now + policy_slice(pol, chosen, C->budget, next_arrival, now);
+        }
+
+        // next event: a slice end, an arrival an idle CPU could take, a balance pass
+        int next = INT_MAX;
+        bool any_idle = false, any_queued = false;
+        for (int c = 0; c < ncpus; ++c) {
+            if (S.cpu[c].running >= 0) { if (S.cpu[c].slice_end < next) next = S.cpu[c].slice_end; }
+            else any_idle = true;
+        }
+        for (int q = 0; q < S.nq && !any_queued; ++q) any_queued = !rq_empty(&S.pols[q].rq);
+        if ((any_idle || next == INT_MAX) && next_arrival < next) next = next_arrival;
+        if (periodic && any_queued && next_balance < next) next = next_balance;
+        STAT_LAP(stats, t_pick, lap);
+
+        // run every CPU up to it
+        for (int c = 0; c < ncpus; ++c) {
+            cpu_t *C = &S.cpu[c];
+            if (lanes) seg_emit(&lanes[c], now, next, C->running);
+            if (C->running < 0) { STAT_ADD(stats, idle_ticks, next - now); continue; }
+            int d = next - now;
+            procs->remaining[C->running] -= d;
+            cpus[c].busy += d;
+            if (procs->remaining[C->running] > 0) policy_tick(pol_of(&S, c), C->running, d, &C->budget);
+        }
+        now = next;
+
+        for (int c = 0; c < ncpus; ++c) {
+            cpu_t *C = &S.cpu[c];
+            if (C->running < 0 || procs->remaining[C->running] > 0) continue;
+            procs->done[C->running] = true;
+            procs->finish_time[C->running] = now;
+            finished++;
+            policy_complete(pol_of(&S, c), C->running);
+            if (acc) macc_complete(acc, procs, C->running);
+            C->running = -1;
+        }
+        STAT_LAP(stats, t_account, lap);
+    }
+
+    if (lanes) {
+        for (int c = 0; c < ncpus; ++c) {
+            cpus[c].segs = lanes[c].v;
+            cpus[c].nsegs = lanes[c].len;
+        }
+        free(lanes);
+    }
+    for (int q = 0; q < S.nq; ++q) STAT_QUEUE(stats, &S.pols[q].rq);
+    STAT_END(stats);
+    for (int q = 0; q < S.nq; ++q) policy_destroy(&S.pols[q]);
+    free(S.pols);
+    free(S.cpu);
+    free(S.running);
+    free(last_cpu);
+    arrivals_destroy(&arrivals);
+    return now; // makespan
+}
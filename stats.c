@@ -0,0 +1,38 @@
+// stats.c — run clocks and queue counters for --stats (see stats.h)
+#include <string.h>
+#include <time.h>
+#include "stats.h"
+
+bool stats_available(void) {
+#ifdef SCHED_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+static double wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+void stats_begin(sched_stats_t *s) {
+    memset(s, 0, sizeof *s);
+    s->ns0_ = wall_ns();
+    s->clock0_ = stats_clock();
+}
+
+void stats_add_queue(sched_stats_t *s, const readyq_t *q) {
+    s->rq_dup_rejects += q->dup_rejects;
+    s->rq_cap_drops += q->cap_drops;
+}
+
+void stats_end(sched_stats_t *s) {
+    s->run_clock = stats_clock() - s->clock0_;
+    s->run_ns = wall_ns() - s->ns0_;
+}
+
+double stats_ns_per_clock(const sched_stats_t *s) {
+    return s->run_clock > 0 ? s->run_ns / (double)s->run_clock : 0;
+}
@@ -0,0 +1,88 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "scheduler_wiring.h"
+
+// Engine instrumentation for --stats: what the scheduler did (counters) and
+// where its own time went (phase timers). The STAT_* hooks below are built
+// in when SCHED_STATS is defined, which the Makefile does by default;
+// `make STATS=0` turns every hook into nothing. When built in, an engine
+// only counts into a non-NULL sched_stats_t, so a run without --stats pays
+// one predictable branch per hook.
+struct sched_stats {
+    long long dispatches;        // slices granted
+    long long context_switches;  // dispatches of a proc other than the last one to run
+    long long preemptions;       // ... while that one was still runnable
+    long long idle_ticks;        // CPU ticks with nothing to run (summed over CPUs)
+    long long decisions;         // pick_next calls; the ready queue depth is sampled at each
+    long long rq_depth_sum;
+    int       rq_depth_max;
+    long long rq_dup_rejects;    // see readyq_t, summed over the run's queues
+    long long rq_cap_drops;
+    long long handoff_waits;     // threaded engine: scheduler waits for a worker's slice
+    long long handoff_parks;     // ... that slept on the condvar instead of catching it spinning
+    long long worker_parks;      // workers that slept waiting for a grant
+
+    // Phase timers in stats_clock() units: admitting arrivals, picking the
+    // next proc and its slice, handing the slice to a worker (or running it
+    // inline) and waiting for it, and bookkeeping (waiting time, timeline,
+    // completion, metrics). run_clock and run_ns time the whole run in both
+    // units, which calibrates the phases to nanoseconds.
+    uint64_t  t_admit, t_pick, t_handoff, t_account;
+    uint64_t  run_clock;
+    double    run_ns;
+    uint64_t  clock0_;           // private to stats_begin / stats_end
+    double    ns0_;
+};
+
+// Cycle counter where there is a cheap one (x86 TSC, arm64 virtual counter),
+// else the monotonic clock in ns
+static inline uint64_t stats_clock(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#ifdef SCHED_STATS
+#define STAT_BEGIN(s)      do { if (s) stats_begin(s); } while (0)
+#define STAT_END(s)        do { if (s) stats_end(s); } while (0)
+#define STAT_QUEUE(s, q)   do { if (s) stats_add_queue((s), (q)); } while (0)
+#define STAT_ADD(s, f, v)  do { if (s) (s)->f += (v); } while (0)
+#define STAT_RQ(s, depth)  do { if (s) stats_rq_sample((s), (depth)); } while (0)
+#define STAT_START(s)      ((s) ? stats_clock() : 0)
+// charge the time since t to phase f and restart t
+#define STAT_LAP(s, f, t)  do { if (s) { uint64_t now_ = stats_clock(); (s)->f += now_ - (t); (t) = now_; } } while (0)
+#else
+#define STAT_BEGIN(s)      ((void)(s))
+#define STAT_END(s)        ((void)(s))
+#define STAT_QUEUE(s, q)   ((void)(s))
+#define STAT_ADD(s, f, v)  ((void)(s), (void)(v))
+#define STAT_RQ(s, depth)  ((void)(s))
+#define STAT_START(s)      ((void)(s), (uint64_t)0)
+#define STAT_LAP(s, f, t)  ((void)(t))
+#endif
+
+static inline void stats_rq_sample(sched_stats_t *s, int depth) {
+    s->decisions++;
+    s->rq_depth_sum += depth;
+    if (depth > s->rq_depth_max) s->rq_depth_max = depth;
+}
+
+bool stats_available(void);                                // built with SCHED_STATS
+void stats_begin(sched_stats_t *s);                        // zero s, start the run clocks
+void stats_add_queue(sched_stats_t *s, const readyq_t *q); // a queue's push rejections
+void stats_end(sched_stats_t *s);                          // stop the run clocks
+double stats_ns_per_clock(const sched_stats_t *s);         // 0 if the run was too short to tell
+
+#endif
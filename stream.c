@@ -0,0 +1,221 @@
+// stream.c — bounded-memory streaming simulation (see stream.h)
+//
+// Rows are read lazily through a small reorder window (a min-heap on arrival,
+// ties in input order, exactly the admission order of the in-memory engines).
+// Admitted processes live in a recycled slot pool that backs both the process
+// table and the ready queue; a slot is released as soon as its process finishes and its
+// row has been reported. Scheduling is the event engine's own dispatch step
+// (ev_dispatch), so results match --engine=event on the same (sorted) input.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "stream.h"
+#include "csvloader.h"
+#include "trace.h"
+#include "report.h"
+
+typedef struct {
+    char pid[32];
+    int  arrival, burst, priority;
+    int  key;     // arrival clamped to tick 0, like arrivals_init
+    long seq;     // input order
+} srow_t;
+
+typedef struct {
+    FILE   *f;
+    char   *line;
+    size_t  linecap;
+    bool    eof, err;
+    srow_t *heap;            // reorder window
+    int     len, cap;
+    long    seq;
+    int     last_key;        // key of the last row released to the engine
+} sreader_t;
+
+static bool srow_less(const srow_t *a, const srow_t *b) {
+    if (a->key != b->key) return a->key < b->key;
+    return a->seq < b->seq;
+}
+
+static void window_push(sreader_t *r, const srow_t *row) {
+    int k = r->len++;
+    while (k > 0) {
+        int parent = (k - 1) / 2;
+        if (!srow_less(row, &r->heap[parent])) break;
+        r->heap[k] = r->heap[parent];
+        k = parent;
+    }
+    r->heap[k] = *row;
+}
+
+static void window_pop(sreader_t *r, srow_t *out) {
+    *out = r->heap[0];
+    srow_t last = r->heap[--r->len];
+    int k = 0;
+    for (;;) {
+        int c = 2 * k + 1;
+        if (c >= r->len) break;
+        if (c + 1 < r->len && srow_less(&r->heap[c + 1], &r->heap[c])) c++;
+        if (!srow_less(&r->heap[c], &last)) break;
+        r->heap[k] = r->heap[c];
+        k = c;
+    }
+    if (r->len > 0) r->heap[k] = last;
+}
+
+// Read rows until the window is full or the file ends
+static void reader_fill(sreader_t *r) {
+    while (!r->eof && !r->err && r->len < r->cap) {
+        if (getline(&r->line, &r->linecap, r->f) < 0) { r->eof = true; break; }
+
+        csv_row_t tmp;
+        int got = csv_parse_row(r->line, &tmp);
+        if (got == 0) continue;
+        if (got < 0) {
+            fprintf(stderr, "Bad CSV row: %s\n", r->line);
+            r->err = true;
+            break;
+        }
+
+        srow_t row;
+        memcpy(row.pid, tmp.pid, sizeof row.pid);
+        row.arrival  = tmp.arrival;
+        row.burst    = tmp.burst;
+        row.priority = tmp.priority;
+        row.key      = tmp.arrival > 0 ? tmp.arrival : 0;
+        row.seq      = r->seq++;
+        window_push(r, &row);
+    }
+}
+
+// Next row in arrival order; -1 if the input is more out of order than the window allows
+static int reader_next(sreader_t *r, srow_t *out) {
+    window_pop(r, out);
+    if (out->key < r->last_key) {
+        fprintf(stderr, "Row %s (arrival %d) is out of order by more than the reorder window; "
+                        "raise --reorder-window or sort the input\n", out->pid, out->arrival);
+        return -1;
+    }
+    r->last_key = out->key;
+    reader_fill(r);
+    return r->err ? -1 : 0;
+}
+
+// ---- slot pool: process table indices recycled as processes finish ----
+typedef struct {
+    proc_table_t procs;   // every slot is a row; PIDs are kept in pid[] instead
+    char       (*pid)[32];
+    int         *free_slots;
+    int          nfree;
+    policy_t     pol;   // its rq grows with the pool
+} slots_t;
+
+static int slot_alloc(slots_t *S) {
+    if (S->nfree == 0) {
+        int old = S->procs.cap, cap = old ? old * 2 : 1024;
+        pt_reserve(&S->procs, cap);
+        S->procs.n = cap;
+        S->pid = (char(*)[32])realloc(S->pid, sizeof *S->pid * cap);
+        S->free_slots = (int*)realloc(S->free_slots, sizeof(int) * cap);
+        for (int i = cap - 1; i >= old; --i) S->free_slots[S->nfree++] = i;
+        rq_reserve(&S->pol.rq, cap, &S->procs);
+    }
+    return S->free_slots[--S->nfree];
+}
+
+static void slot_free(slots_t *S, int i) {
+    S->free_slots[S->nfree++] = i;
+}
+
+int run_stream(const char *path, const policy_ops_t *policy, const sched_params_t *sp, int reorder_window,
+               report_t *rep) {
+    if (trace_is_binary(path)) {
+        fprintf(stderr, "%s: --stream reads CSV only; binary traces load without parsing, "
+                        "run them without --stream\n", path);
+        return 1;
+    }
+    sreader_t r = {0};
+    r.f = fopen(path, "r");
+    if (!r.f) { perror("fopen"); return 1; }
+    r.cap = (reorder_window > 0 ? reorder_window : 0) + 1;
+    r.heap = (srow_t*)malloc(sizeof(srow_t) * r.cap);
+    r.last_key = INT_MIN;
+    reader_fill(&r);
+
+    slots_t S = {0};
+    pt_init(&S.procs);
+    policy_init(&S.pol, policy, &S.procs, 0, sp);
+
+    report_info_t info = { policy->label, 1, NULL, true, 0, 0 };
+    report_begin(rep, &info);
+
+    // bounded memory end to end: the summary comes from an accumulator, not a table
+    metrics_acc_t acc;
+    macc_init(&acc);
+    int max_wait = -1;
+    char max_wait_pid[32] = "";
+    int live = 0, peak_live = 0;
+    ev_state_t ev = { .pol = &S.pol, .running_idx = -1, .last_ran = -1 };
+    bool failed = r.err;
+
+    while (!failed) {
+        // admit everything that has arrived by now
+        while (r.len > 0 && r.heap[0].arrival <= ev.now) {
+            srow_t row;
+            if (reader_next(&r, &row) != 0) { failed = true; break; }
+            int i = slot_alloc(&S);
+            proc_table_t *P = &S.procs;
+            memcpy(S.pid[i], row.pid, sizeof S.pid[i]);
+            P->arrival[i] = row.arrival; P->burst[i] = row.burst; P->priority[i] = row.priority;
+            P->remaining[i] = row.burst;
+            P->started_time[i] = P->finish_time[i] = -1;
+            P->response_time[i] = P->waiting_time[i] = 0;
+            P->ready_since[i] = row.key;
+            P->level[i] = 0;
+            P->vruntime[i] = 0;
+            P->done[i] = false;
+            policy_arrive(&S.pol, &i, 1);
+            if (++live > peak_live) peak_live = live;
+        }
+        if (failed) break;
+        if (ev.running_idx < 0 && rq_empty(&S.pol.rq) && r.len == 0) break;   // drained
+
+        // the event engine's dispatch, on the slot table
+        int chosen = ev_dispatch(&ev, (r.len > 0) ? r.heap[0].arrival : INT_MAX);
+        if (chosen < 0) {   // idle until the next arrival
+            ev.now = r.heap[0].arrival;
+            continue;
+        }
+        if (!S.procs.done[chosen]) continue;
+
+        // finished: emit its record and retire the slot
+        proc_table_t *procs = &S.procs;
+        report_row(rep, procs, chosen, S.pid[chosen], (int)strlen(S.pid[chosen]));
+        macc_complete(&acc, procs, chosen);
+        if (procs->waiting_time[chosen] > max_wait) {
+            max_wait = procs->waiting_time[chosen];
+            memcpy(max_wait_pid, S.pid[chosen], sizeof max_wait_pid);
+        }
+        slot_free(&S, chosen);
+        live--;
+    }
+
+    if (!failed && acc.wait.n > 0) {
+        // slots are recycled, so the max-wait proc is tracked by PID above
+        metrics_t M = metrics_from_acc(&acc, ev.now, 1);
+        report_summary(rep, &M, ev.now, max_wait_pid, (int)strlen(max_wait_pid), peak_live);
+    } else if (!failed) {
+        fprintf(stderr, "No processes found in %s\n", path);
+        failed = true;
+    }
+
+    policy_destroy(&S.pol);
+    pt_free(&S.procs);
+    free(S.pid);
+    free(S.free_slots);
+    free(r.heap);
+    free(r.line);
+    fclose(r.f);
+    return failed ? 1 : 0;
+}
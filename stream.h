@@ -0,0 +1,17 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "scheduler_wiring.h"
+
+// Streaming simulation for traces too large to load: rows are read as the
+// clock reaches them and each finished process is reported and retired, so
+// memory is bounded by live processes (queued + running + reorder window),
+// not by trace length. Input must be sorted by arrival, except that a row may
+// appear up to reorder_window rows later than its sorted position.
+// Event-driven; supports every registered policy. Rows and summary go to rep
+// (report.h), which the caller opens and closes. Returns 0 on success.
+typedef struct report report_t;
+int run_stream(const char *path, const policy_ops_t *policy, const sched_params_t *sp, int reorder_window,
+               report_t *rep);
+
+#endif
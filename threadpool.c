@@ -0,0 +1,186 @@
+// threadpool.c — work-stealing pool used by batch mode
+#include "threadpool.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct {
+    tp_task_fn fn;
+    void      *arg;
+} tp_task_t;
+
+// Per-worker deque: owner pushes/pops at the bottom, thieves take the top
+typedef struct {
+    tp_task_t      *v;
+    int             top, bottom, cap;
+    pthread_mutex_t mu;
+} tp_deque_t;
+
+struct tpool {
+    int             nthreads;
+    pthread_t      *ths;
+    tp_deque_t     *dq;
+    int             next_submit;   // round-robin target for tp_submit
+
+    pthread_mutex_t mu;            // guards pending/queued/stop + both condvars
+    pthread_cond_t  work_cv;       // signalled when tasks are queued or on stop
+    pthread_cond_t  idle_cv;       // signalled when pending drops to 0
+    int             queued;        // tasks sitting in some deque
+    int             pending;       // tasks submitted but not yet finished
+    bool            stop;
+};
+
+typedef struct {
+    tpool_t *tp;
+    int      self;
+} tp_worker_arg_t;
+
+int tp_default_threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+static void dq_push_bottom(tp_deque_t *d, tp_task_t t) {
+    pthread_mutex_lock(&d->mu);
+    if (d->bottom == d->cap) {
+        // slide live entries to the front before growing
+        int live = d->bottom - d->top;
+        for (int k = 0; k < live; ++k) d->v[k] = d->v[d->top + k];
+        d->top = 0; d->bottom = live;
+        if (d->bottom == d->cap) {
+            d->cap = d->cap ? d->cap * 2 : 16;
+            d->v = (tp_task_t*)realloc(d->v, sizeof(tp_task_t) * d->cap);
+        }
+    }
+    d->v[d->bottom++] = t;
+    pthread_mutex_unlock(&d->mu);
+}
+
+static bool dq_pop_bottom(tp_deque_t *d, tp_task_t *out) {
+    bool ok = false;
+    pthread_mutex_lock(&d->mu);
+    if (d->bottom > d->top) { *out = d->v[--d->bottom]; ok = true; }
+    pthread_mutex_unlock(&d->mu);
+    return ok;
+}
+
+static bool dq_steal_top(tp_deque_t *d, tp_task_t *out) {
+    bool ok = false;
+    pthread_mutex_lock(&d->mu);
+    if (d->bottom > d->top) { *out = d->v[d->top++]; ok = true; }
+    pthread_mutex_unlock(&d->mu);
+    return ok;
+}
+
+static bool tp_take(tpool_t *tp, int self, tp_task_t *out) {
+    if (dq_pop_bottom(&tp->dq[self], out)) return true;
+    for (int k = 1; k < tp->nthreads; ++k) {
+        if (dq_steal_top(&tp->dq[(self + k) % tp->nthreads], out)) return true;
+    }
+    return false;
+}
+
+static void *tp_worker(void *arg) {
+    tpool_t *tp = ((tp_worker_arg_t*)arg)->tp;
+    int self = ((tp_worker_arg_t*)arg)->self;
+    free(arg);
+
+    for (;;) {
+        pthread_mutex_lock(&tp->mu);
+        while (tp->queued == 0 && !tp->stop) pthread_cond_wait(&tp->work_cv, &tp->mu);
+        if (tp->queued == 0 && tp->stop) { pthread_mutex_unlock(&tp->mu); break; }
+        pthread_mutex_unlock(&tp->mu);
+
+        tp_task_t t;
+        if (!tp_take(tp, self, &t)) continue;   // lost the race to another thief
+
+        pthread_mutex_lock(&tp->mu);
+        tp->queued--;
+        pthread_mutex_unlock(&tp->mu);
+
+        t.fn(t.arg);
+
+        pthread_mutex_lock(&tp->mu);
+        if (--tp->pending == 0) pthread_cond_broadcast(&tp->idle_cv);
+        pthread_mutex_unlock(&tp->mu);
+    }
+    return NULL;
+}
+
+tpool_t *tp_create(int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+    tpool_t *tp = (tpool_t*)calloc(1, sizeof(tpool_t));
+    tp->nthreads = nthreads;
+    tp->ths = (pthread_t*)malloc(sizeof(pthread_t) * nthreads);
+    tp->dq  = (tp_deque_t*)calloc(nthreads, sizeof(tp_deque_t));
+    pthread_mutex_init(&tp->mu, NULL);
+    pthread_cond_init(&tp->work_cv, NULL);
+    pthread_cond_init(&tp->idle_cv, NULL);
+    for (int i = 0; i < nthreads; ++i) pthread_mutex_init(&tp->dq[i].mu, NULL);
+    int started = 0;
+    for (; started < nthreads; ++started) {
+        tp_worker_arg_t *a = (tp_worker_arg_t*)malloc(sizeof(tp_worker_arg_t));
+        a->tp = tp; a->self = started;
+        if (pthread_create(&tp->ths[started], NULL, tp_worker, a) != 0) { free(a); break; }
+    }
+    if (started < nthreads) {
+        fprintf(stderr, "warning: started %d of %d pool threads\n", started, nthreads);
+        // shrink to the threads that run; no task has been submitted yet, so
+        // the unused deques are still empty
+        pthread_mutex_lock(&tp->mu);
+        tp->nthreads = started;
+        pthread_mutex_unlock(&tp->mu);
+        for (int i = started; i < nthreads; ++i) pthread_mutex_destroy(&tp->dq[i].mu);
+        if (started == 0) {
+            tp_destroy(tp);
+            return NULL;
+        }
+    }
+    return tp;
+}
+
+int tp_threads(const tpool_t *tp) { return tp->nthreads; }
+
+void tp_submit(tpool_t *tp, tp_task_fn fn, void *arg) {
+    int target = tp->next_submit;
+    tp->next_submit = (tp->next_submit + 1) % tp->nthreads;
+
+    pthread_mutex_lock(&tp->mu);
+    tp->pending++;
+    pthread_mutex_unlock(&tp->mu);
+
+    dq_push_bottom(&tp->dq[target], (tp_task_t){ fn, arg });
+
+    pthread_mutex_lock(&tp->mu);
+    tp->queued++;
+    pthread_cond_signal(&tp->work_cv);
+    pthread_mutex_unlock(&tp->mu);
+}
+
+void tp_wait(tpool_t *tp) {
+    pthread_mutex_lock(&tp->mu);
+    while (tp->pending > 0) pthread_cond_wait(&tp->idle_cv, &tp->mu);
+    pthread_mutex_unlock(&tp->mu);
+}
+
+void tp_destroy(tpool_t *tp) {
+    if (!tp) return;
+    tp_wait(tp);
+    pthread_mutex_lock(&tp->mu);
+    tp->stop = true;
+    pthread_cond_broadcast(&tp->work_cv);
+    pthread_mutex_unlock(&tp->mu);
+    for (int i = 0; i < tp->nthreads; ++i) pthread_join(tp->ths[i], NULL);
+    for (int i = 0; i < tp->nthreads; ++i) {
+        pthread_mutex_destroy(&tp->dq[i].mu);
+        free(tp->dq[i].v);
+    }
+    pthread_cond_destroy(&tp->idle_cv);
+    pthread_cond_destroy(&tp->work_cv);
+    pthread_mutex_destroy(&tp->mu);
+    free(tp->dq);
+    free(tp->ths);
+    free(tp);
+}
@@ -0,0 +1,19 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// Fixed-size work-stealing thread pool. Each worker owns a deque: it pops its
+// own work LIFO from the bottom and, when empty, steals FIFO from the top of
+// another worker's deque.
+
+typedef void (*tp_task_fn)(void *arg);
+
+typedef struct tpool tpool_t;
+
+int      tp_default_threads(void);             // online cores (>= 1)
+tpool_t *tp_create(int nthreads);             // fewer threads if some fail to start, NULL if none do
+int      tp_threads(const tpool_t *tp);        // threads actually running
+void     tp_submit(tpool_t *tp, tp_task_fn fn, void *arg);
+void     tp_wait(tpool_t *tp);                 // block until every submitted task ran
+void     tp_destroy(tpool_t *tp);              // waits, then joins the workers
+
+#endif
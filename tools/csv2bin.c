@@ -0,0 +1,27 @@
+// csv2bin.c — convert a process CSV to the binary trace format (see trace.h)
+//
+//   usage: csv2bin <input.csv> <output.bin>
+//
+// The output is accepted anywhere sched takes an input file; it is detected
+// by its magic, so -i trace.bin works with every engine and mode.
+#include <stdio.h>
+#include <stdlib.h>
+#include "../csvloader.h"
+#include "../trace.h"
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <input.csv> <output.bin>\n", argv[0]);
+        return 2;
+    }
+
+    proc_table_t procs;
+    if (load_csv(argv[1], &procs) != 0) {
+        fprintf(stderr, "Failed to load input: %s\n", argv[1]);
+        return 1;
+    }
+    int rc = trace_write(argv[2], &procs);
+    if (rc == 0) printf("%s: %d processes -> %s\n", argv[1], procs.n, argv[2]);
+    pt_free(&procs);
+    return rc == 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// wlgen.c — seeded synthetic workloads (see wlgen.h)
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include "wlgen.h"
+#include "../outbuf.h"
+
+void wl_defaults(wl_params_t *p) {
+    p->n = 100000;
+    p->seed = 1;
+    p->dist = WL_EXP;
+    p->mean_burst = 10.0;
+    p->load = 0.9;
+    p->priorities = 10;
+    p->max_burst = 1000000;
+    p->edge = 0;
+}
+
+static const char *dist_names[] = { "exp", "bimodal", "pareto" };
+
+int wl_parse_dist(const char *s, wl_dist_t *out) {
+    for (int d = 0; d < 3; ++d)
+        if (strcasecmp(s, dist_names[d]) == 0) { *out = (wl_dist_t)d; return 0; }
+    return -1;
+}
+
+const char *wl_dist_name(wl_dist_t d) { return dist_names[d]; }
+
+// splitmix64: tiny, seedable from any value, identical on every platform
+uint64_t wl_next_u64(uint64_t *s) {
+    uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in (0, 1]: never 0, so log() below is finite
+static double next_unit(uint64_t *s) {
+    return ((double)(wl_next_u64(s) >> 11) + 1.0) * (1.0 / 9007199254740992.0);
+}
+
+static double next_exp(uint64_t *s, double mean) {
+    return -mean * log(next_unit(s));
+}
+
+static int draw_burst(const wl_params_t *p, uint64_t *s) {
+    double m = p->mean_burst, b;
+    switch (p->dist) {
+    case WL_BIMODAL: {
+        // short mean m/4 with p = 0.9; long mean solves 0.9 m/4 + 0.1 L = m
+        double shrt = m / 4, lng = (m - 0.9 * shrt) / 0.1;
+        b = next_exp(s, next_unit(s) <= 0.9 ? shrt : lng);
+        break;
+    }
+    case WL_PARETO: {
+        const double alpha = 1.5;               // finite mean, infinite variance
+        double xm = m * (alpha - 1) / alpha;    // scale for the requested mean
+        b = xm / pow(next_unit(s), 1.0 / alpha);
+        break;
+    }
+    default:
+        b = next_exp(s, m);
+        break;
+    }
+    if (b > p->max_burst) b = p->max_burst;
+    int burst = (int)lround(b);   // nearest, so the mean is kept
+    return burst < 1 ? 1 : burst;
+}
+
+void wl_generate(const wl_params_t *p, proc_table_t *out) {
+    uint64_t s = p->seed;
+    double gap = p->mean_burst / (p->load > 0 ? p->load : 1.0);   // mean inter-arrival
+    double t = 0;
+    int nprio = p->priorities > 0 ? p->priorities : 1;
+
+    pt_init(out);
+    pt_reserve(out, (int)p->n);
+    for (long i = 0; i < p->n; ++i) {
+        char pid[24];
+        int len = snprintf(pid, sizeof pid, "P%ld", i);
+        int burst = draw_burst(p, &s);
+        int prio = (int)(wl_next_u64(&s) % (uint64_t)nprio);
+        int arrival = (int)t;
+        if (p->edge > 0) {
+            // values the loader accepts but a normal draw never makes: a proc
+            // with nothing to run, a negative (nice-style) priority, an arrival
+            // before t = 0. Only drawn when asked for, so edge = 0 keeps the
+            // sequence, and the table, of earlier versions.
+            if (next_unit(&s) <= p->edge) burst = 0;
+            if (next_unit(&s) <= p->edge) prio = -1 - (int)(wl_next_u64(&s) % (uint64_t)nprio);
+            if (next_unit(&s) <= p->edge) arrival = -1 - (int)(wl_next_u64(&s) % 10);
+        }
+        pt_append(out, pid, len, arrival, burst, prio);
+        t += next_exp(&s, gap);
+    }
+}
+
+int wl_write_csv(const char *path, const proc_table_t *procs) {
+    FILE *f = fopen(path, "w");
+    if (!f) { perror(path); return -1; }
+    outbuf_t ob;
+    ob_init(&ob, f);
+    ob_puts(&ob, "# pid,arrival,burst,priority\n");
+    for (int i = 0; i < procs->n; ++i) {
+        ob_write(&ob, pt_pid(procs, i), pt_pid_len(procs, i));
+        ob_putc(&ob, ','); ob_int(&ob, procs->arrival[i]);
+        ob_putc(&ob, ','); ob_int(&ob, procs->burst[i]);
+        ob_putc(&ob, ','); ob_int(&ob, procs->priority[i]);
+        ob_putc(&ob, '\n');
+    }
+    int rc = ob_close(&ob);
+    if (fclose(f) != 0) rc = -1;
+    if (rc != 0) fprintf(stderr, "%s: write failed\n", path);
+    return rc;
+}
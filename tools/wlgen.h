@@ -0,0 +1,39 @@
+#ifndef WLGEN_H
+#define WLGEN_H
+
+#include <stdint.h>
+#include "../scheduler_wiring.h"   // proc_table_t
+
+// Seeded synthetic workloads for benchmarks: Poisson arrivals (exponential
+// inter-arrival gaps) at a rate that gives the requested CPU load, and
+// bursts from one of three shapes. The same parameters and seed always give
+// the same table, on any host.
+typedef enum {
+    WL_EXP,        // exponential bursts
+    WL_BIMODAL,    // 90% short (mean / 4), 10% long, same overall mean
+    WL_PARETO      // heavy-tailed, shape 1.5, same mean
+} wl_dist_t;
+
+typedef struct {
+    long      n;           // processes
+    uint64_t  seed;
+    wl_dist_t dist;
+    double    mean_burst;  // ticks, >= 1
+    double    load;        // offered load: arrival rate x mean burst (0.9 = 90% busy)
+    int       priorities;  // priorities drawn from 0 .. priorities-1
+    int       max_burst;   // clamp for the heavy tail
+    double    edge;        // chance per process of each edge case, drawn independently:
+                           // zero burst, negative priority, negative arrival (0 = none)
+} wl_params_t;
+
+void        wl_defaults(wl_params_t *p);
+int         wl_parse_dist(const char *s, wl_dist_t *out);   // 0 ok, -1 unknown
+const char *wl_dist_name(wl_dist_t d);
+uint64_t    wl_next_u64(uint64_t *state);   // the generator's PRNG (splitmix64)
+
+// Fill a fresh table (release with pt_free); PIDs are P0, P1, ...
+void wl_generate(const wl_params_t *p, proc_table_t *out);
+// Same table as CSV, readable by load_workload. 0 ok, -1 error (reported).
+int  wl_write_csv(const char *path, const proc_table_t *procs);
+
+#endif
@@ -0,0 +1,225 @@
+// trace.c — binary workload traces: writer, zero-copy mmap reader
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace.h"
+#include "csvloader.h"
+
+static uint64_t align8(uint64_t x) { return (x + 7) & ~(uint64_t)7; }
+
+// [off, off + size) lies within a file of len bytes, without overflowing
+static int in_file(uint64_t off, uint64_t size, uint64_t len) {
+    return off <= len && size <= len - off;
+}
+
+int trace_is_binary(const char *path) {
+    char magic[8];
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    size_t got = fread(magic, 1, sizeof magic, f);
+    fclose(f);
+    return got == sizeof magic && memcmp(magic, TRACE_MAGIC, sizeof magic) == 0;
+}
+
+int trace_open(const char *path, trace_t *t) {
+    memset(t, 0, sizeof *t);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { perror("open"); return -1; }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(trace_hdr_t)) {
+        fprintf(stderr, "%s: not a binary trace (too short)\n", path);
+        close(fd);
+        return -1;
+    }
+    // private and writable: copy-on-write, so a table built on the mapping
+    // can update its input columns (never the file) without copying them
+    void *m = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) { perror("mmap"); return -1; }
+
+    const trace_hdr_t *h = (const trace_hdr_t*)m;
+    size_t len = (size_t)st.st_size;
+    const char *why = NULL;
+    if (memcmp(h->magic, TRACE_MAGIC, sizeof h->magic) != 0) why = "bad magic";
+    else if (h->version != TRACE_VERSION)                     why = "unsupported version";
+    else if (h->endian != TRACE_ENDIAN)                       why = "written on a host with other endianness";
+    else if (h->nprocs > 0x7fffffffu)                         why = "too many processes";
+    else {
+        uint64_t n = h->nprocs, col = n * 4;
+        if (h->nstr >= len / 4 ||   // bounds nstr before (nstr + 1) * 4
+            !in_file(h->off_arrival, col, len)  || !in_file(h->off_burst, col, len) ||
+            !in_file(h->off_priority, col, len) || !in_file(h->off_pid_id, col, len) ||
+            !in_file(h->off_str_off, (h->nstr + 1) * 4, len) || h->off_str_data > len ||
+            ((h->off_arrival | h->off_burst | h->off_priority | h->off_pid_id | h->off_str_off) & 3))
+            why = "truncated or corrupt section table";
+    }
+    if (!why) {
+        const uint32_t *ids = (const uint32_t*)((const char*)m + h->off_pid_id);
+        const uint32_t *so  = (const uint32_t*)((const char*)m + h->off_str_off);
+        // every PID is read as str_data[so[k] .. so[k + 1]), so the offsets must
+        // be non-decreasing and end inside the file
+        if (so[h->nstr] > len - h->off_str_data) why = "truncated string table";
+        for (uint64_t k = 0; !why && k < h->nstr; ++k)
+            if (so[k] > so[k + 1]) why = "corrupt string table";
+        for (uint64_t i = 0; !why && i < h->nprocs; ++i)
+            if (ids[i] >= h->nstr) why = "pid index out of range";
+    }
+    if (why) {
+        fprintf(stderr, "%s: %s\n", path, why);
+        munmap(m, len);
+        return -1;
+    }
+
+    const char *base = (const char*)m;
+    t->arrival  = (const int32_t*)(base + h->off_arrival);
+    t->burst    = (const int32_t*)(base + h->off_burst);
+    t->priority = (const int32_t*)(base + h->off_priority);
+    t->pid_id   = (const uint32_t*)(base + h->off_pid_id);
+    t->str_off  = (const uint32_t*)(base + h->off_str_off);
+    t->str_data = base + h->off_str_data;
+    t->nprocs   = (size_t)h->nprocs;
+    t->nstr     = (size_t)h->nstr;
+    t->map      = m;
+    t->map_len  = len;
+    return 0;
+}
+
+void trace_close(trace_t *t) {
+    if (t->map) munmap(t->map, t->map_len);
+    memset(t, 0, sizeof *t);
+}
+
+// ---- writer ----
+
+// Open-addressing PID intern table (FNV-1a)
+typedef struct {
+    uint32_t *slot;    // string id + 1, 0 = empty
+    size_t    mask;
+} intern_t;
+
+static uint64_t fnv1a(const char *s, int len) {
+    uint64_t h = 1469598103934665603ull;
+    for (int k = 0; k < len; ++k) { h ^= (unsigned char)s[k]; h *= 1099511628211ull; }
+    return h;
+}
+
+static int write_section(FILE *f, uint64_t *pos, uint64_t off, const void *p, size_t len) {
+    static const char zero[8] = {0};
+    if (off > *pos && fwrite(zero, 1, (size_t)(off - *pos), f) != off - *pos) return -1;
+    if (len && fwrite(p, 1, len, f) != len) return -1;
+    *pos = off + len;
+    return 0;
+}
+
+int trace_write(const char *path, const proc_table_t *procs) {
+    size_t n = (procs->n > 0) ? (size_t)procs->n : 0;
+    int32_t  *arr  = (int32_t*)malloc(sizeof(int32_t) * (n + 1));
+    int32_t  *bur  = (int32_t*)malloc(sizeof(int32_t) * (n + 1));
+    int32_t  *pri  = (int32_t*)malloc(sizeof(int32_t) * (n + 1));
+    uint32_t *ids  = (uint32_t*)malloc(sizeof(uint32_t) * (n + 1));
+    uint32_t *soff = (uint32_t*)malloc(sizeof(uint32_t) * (n + 2));
+    size_t    pid_bytes = 0;
+    for (size_t i = 0; i < n; ++i) pid_bytes += (size_t)pt_pid_len(procs, (int)i);
+    char     *sdat = (char*)malloc(pid_bytes + 1);
+    size_t nstr = 0, sbytes = 0;
+
+    intern_t H;
+    H.mask = 1024;
+    while (H.mask < 2 * n) H.mask <<= 1;
+    H.slot = (uint32_t*)calloc(H.mask, sizeof(uint32_t));
+    H.mask -= 1;
+
+    soff[0] = 0;
+    memcpy(arr, procs->arrival,  sizeof(int32_t) * n);
+    memcpy(bur, procs->burst,    sizeof(int32_t) * n);
+    memcpy(pri, procs->priority, sizeof(int32_t) * n);
+    for (size_t i = 0; i < n; ++i) {
+        const char *pid = pt_pid(procs, (int)i);
+        size_t plen = (size_t)pt_pid_len(procs, (int)i);
+        size_t k = (size_t)fnv1a(pid, (int)plen) & H.mask;
+        for (;; k = (k + 1) & H.mask) {
+            uint32_t s = H.slot[k];
+            if (s == 0) {   // new string
+                memcpy(sdat + sbytes, pid, plen);
+                sbytes += plen;
+                soff[nstr + 1] = (uint32_t)sbytes;
+                H.slot[k] = (uint32_t)(++nstr);
+                ids[i] = (uint32_t)(nstr - 1);
+                break;
+            }
+            const char *cand = sdat + soff[s - 1];
+            size_t clen = soff[s] - soff[s - 1];
+            if (clen == plen && memcmp(cand, pid, plen) == 0) { ids[i] = s - 1; break; }
+        }
+    }
+    free(H.slot);
+
+    trace_hdr_t h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, TRACE_MAGIC, sizeof h.magic);
+    h.version      = TRACE_VERSION;
+    h.endian       = TRACE_ENDIAN;
+    h.nprocs       = n;
+    h.nstr         = nstr;
+    h.off_arrival  = align8(sizeof h);
+    h.off_burst    = align8(h.off_arrival  + 4 * n);
+    h.off_priority = align8(h.off_burst    + 4 * n);
+    h.off_pid_id   = align8(h.off_priority + 4 * n);
+    h.off_str_off  = align8(h.off_pid_id   + 4 * n);
+    h.off_str_data = align8(h.off_str_off  + 4 * (nstr + 1));
+
+    int rc = -1;
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror("fopen");
+    } else {
+        uint64_t pos = 0;
+        if (write_section(f, &pos, 0,              &h,   sizeof h)         == 0 &&
+            write_section(f, &pos, h.off_arrival,  arr,  4 * n)            == 0 &&
+            write_section(f, &pos, h.off_burst,    bur,  4 * n)            == 0 &&
+            write_section(f, &pos, h.off_priority, pri,  4 * n)            == 0 &&
+            write_section(f, &pos, h.off_pid_id,   ids,  4 * n)            == 0 &&
+            write_section(f, &pos, h.off_str_off,  soff, 4 * (nstr + 1))   == 0 &&
+            write_section(f, &pos, h.off_str_data, sdat, sbytes)           == 0)
+            rc = 0;
+        if (fclose(f) != 0) rc = -1;
+        if (rc != 0) fprintf(stderr, "%s: write failed\n", path);
+    }
+
+    free(arr); free(bur); free(pri); free(ids); free(soff); free(sdat);
+    return rc;
+}
+
+// ---- loading ----
+
+/* The table's input columns and PIDs are the mapped trace sections; only the
+   run-state columns are allocated. pt_free unmaps. *out is always safe to
+   pt_free, even on failure. */
+int load_workload(const char *path, proc_table_t *out) {
+    pt_init(out);
+    if (!trace_is_binary(path)) return load_csv(path, out);
+
+    trace_t t;
+    if (trace_open(path, &t) != 0) return -1;
+
+    proc_table_t T;
+    pt_init(&T);
+    T.n        = (int)t.nprocs;
+    T.arrival  = (int*)t.arrival;      // writable: the mapping is copy-on-write
+    T.burst    = (int*)t.burst;
+    T.priority = (int*)t.priority;
+    T.pid_id   = (uint32_t*)t.pid_id;
+    T.pid_off  = (uint32_t*)t.str_off;
+    T.pid_str  = (char*)t.str_data;
+    T.map      = t.map;
+    T.map_len  = t.map_len;
+    pt_reserve(&T, T.n > 0 ? T.n : 1);
+
+    *out = T;
+    return 0;
+}
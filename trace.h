@@ -0,0 +1,57 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "scheduler_wiring.h"   // proc_table_t
+
+/* Binary workload trace (written by csv2bin, all fields native little-endian):
+ *
+ *   trace_hdr_t                       fixed-size header (88 bytes)
+ *   int32_t  arrival[n]               \
+ *   int32_t  burst[n]                  | columnar process table
+ *   int32_t  priority[n]               |
+ *   uint32_t pid_id[n]                /  index into the PID string table
+ *   uint32_t str_off[nstr + 1]        interned PIDs: string k is
+ *   char     str_data[...]            str_data[str_off[k] .. str_off[k+1])
+ *
+ * Every section starts on an 8-byte boundary; offsets are from file start.
+ */
+#define TRACE_MAGIC   "SCHEDTRC"
+#define TRACE_VERSION 1u
+#define TRACE_ENDIAN  0x01020304u
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t endian;        // TRACE_ENDIAN as written by the producer
+    uint64_t nprocs;
+    uint64_t nstr;
+    uint64_t off_arrival, off_burst, off_priority, off_pid_id;
+    uint64_t off_str_off, off_str_data;
+} trace_hdr_t;
+
+/* A mapped trace. The column pointers point straight into the (private,
+   copy-on-write) mapping. */
+typedef struct {
+    const int32_t  *arrival, *burst, *priority;
+    const uint32_t *pid_id;
+    const uint32_t *str_off;
+    const char     *str_data;
+    size_t          nprocs, nstr;
+    void           *map;
+    size_t          map_len;
+} trace_t;
+
+int  trace_is_binary(const char *path);
+int  trace_open(const char *path, trace_t *t);      // 0 ok, -1 error (reported)
+void trace_close(trace_t *t);
+
+/* Write a table's inputs as a binary trace, interning PIDs. 0 ok, -1 error. */
+int  trace_write(const char *path, const proc_table_t *procs);
+
+/* Load either format into *out (release with pt_free): binary traces are
+   detected by magic and used in place, anything else is parsed as CSV */
+int  load_workload(const char *path, proc_table_t *out);
+
+#endif
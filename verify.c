@@ -0,0 +1,314 @@
+// verify.c — differential check of the engines (see verify.h).
+//
+// Every engine runs on the same proc_table_t, reset between runs, and its
+// results are copied out before the next run overwrites them. The reference
+// is the threaded engine, the one the others were derived from. RR also
+// checks the --quantum-range row at the run's quantum against the event
+// engine, the loop the sweep follows.
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "verify.h"
+#include "metrics.h"
+#include "rr_sweep.h"
+#include "stats.h"
+#include "trace.h"
+#include "tools/wlgen.h"
+
+enum { ENG_THREADED, ENG_INLINE, ENG_EVENT, ENG_SMP1, ENG_COUNT };
+static const char *eng_names[ENG_COUNT] = { "threaded", "inline", "event", "smp-1" };
+
+enum { COL_START, COL_FINISH, COL_WAIT, COL_RESP, NCOLS };
+static const char *col_names[NCOLS] = { "started_time", "finish_time", "waiting_time", "response_time" };
+
+// One engine's results
+typedef struct {
+    int       makespan;
+    tl_seg_t *segs;
+    int       nsegs;
+    int      *col[NCOLS];   // copies of the table's result columns
+    metrics_t M;
+} vrun_t;
+
+static void vrun(vrun_t *R, int engine, proc_table_t *procs, const policy_ops_t *policy,
+                 const sched_params_t *sp, int workers) {
+    metrics_acc_t acc;
+    macc_init(&acc);
+    pt_reset(procs);
+    memset(R, 0, sizeof *R);
+
+    switch (engine) {
+    case ENG_THREADED:
+        R->makespan = run_scheduler(procs, policy, sp, workers, &acc, NULL, &R->segs, &R->nsegs);
+        break;
+    case ENG_INLINE:
+        R->makespan = run_scheduler_inline(procs, policy, sp, &acc, NULL, &R->segs, &R->nsegs);
+        break;
+    case ENG_EVENT:
+        R->makespan = run_scheduler_events(procs, policy, sp, &acc, NULL, &R->segs, &R->nsegs);
+        break;
+    default: {
+        smp_config_t cfg = { 1, RQ_POLICY_PERCPU, BALANCE_NONE, 0 };
+        cpu_stats_t cpu;
+        R->makespan = run_scheduler_smp(procs, policy, sp, &acc, NULL, &cfg, &cpu, true);
+        R->segs = cpu.segs;
+        R->nsegs = cpu.nsegs;
+        break;
+    }
+    }
+    // single-CPU summary for every engine, so all of them compare field by field
+    R->M = metrics_from_acc(&acc, R->makespan, 1);
+
+    const int *src[NCOLS] = { procs->started_time, procs->finish_time, procs->waiting_time,
+                              procs->response_time };
+    size_t bytes = sizeof(int) * (size_t)(procs->n > 0 ? procs->n : 1);
+    for (int c = 0; c < NCOLS; ++c) {
+        R->col[c] = (int*)malloc(bytes);
+        memcpy(R->col[c], src[c], sizeof(int) * (size_t)procs->n);
+    }
+}
+
+static void vrun_free(vrun_t *R) {
+    free(R->segs);
+    for (int c = 0; c < NCOLS; ++c) free(R->col[c]);
+    metrics_free(&R->M);
+}
+
+// First tick at which a and b run different procs (or one timeline ends),
+// -1 if they are identical; *pa, *pb are the procs then (-1 idle or ended).
+// Timelines cover [0, makespan) without gaps, idle included.
+static int first_divergence(const vrun_t *a, const vrun_t *b, int *pa, int *pb) {
+    int i = 0, j = 0, t = 0;
+    while (i < a->nsegs && j < b->nsegs) {
+        const tl_seg_t *x = &a->segs[i], *y = &b->segs[j];
+        if (x->proc != y->proc) { *pa = x->proc; *pb = y->proc; return t; }
+        t = x->end < y->end ? x->end : y->end;
+        if (x->end == t) ++i;
+        if (y->end == t) ++j;
+    }
+    if (i == a->nsegs && j == b->nsegs) return -1;
+    *pa = i < a->nsegs ? a->segs[i].proc : -1;
+    *pb = j < b->nsegs ? b->segs[j].proc : -1;
+    return t;
+}
+
+// Output for one comparison; the heading goes out before its first line
+typedef struct {
+    const char *heading;
+    const char *name;    // engine under test
+    int         lines;
+} vout_t;
+
+static void vline(vout_t *o, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void vline(vout_t *o, const char *fmt, ...) {
+    if (o->heading) { fputs(o->heading, stdout); o->heading = NULL; }
+    if (o->lines++ == 0) printf("  %-9s MISMATCH\n", o->name);
+    va_list ap;
+    va_start(ap, fmt);
+    printf("  %-9s ", "");
+    vprintf(fmt, ap);
+    putchar('\n');
+    va_end(ap);
+}
+
+static const char *pid_or_idle(const proc_table_t *procs, int i, int *len) {
+    if (i < 0) { *len = 4; return "IDLE"; }
+    *len = pt_pid_len(procs, i);
+    return pt_pid(procs, i);
+}
+
+static void cmp_dist(vout_t *o, const char *name, const dist_summary_t *a, const dist_summary_t *b) {
+    if (a->mean != b->mean)     vline(o, "metrics.%s.mean: %.6f vs %.6f", name, a->mean, b->mean);
+    if (a->stddev != b->stddev) vline(o, "metrics.%s.stddev: %.6f vs %.6f", name, a->stddev, b->stddev);
+    if (a->p50 != b->p50)       vline(o, "metrics.%s.p50: %d vs %d", name, a->p50, b->p50);
+    if (a->p95 != b->p95)       vline(o, "metrics.%s.p95: %d vs %d", name, a->p95, b->p95);
+    if (a->p99 != b->p99)       vline(o, "metrics.%s.p99: %d vs %d", name, a->p99, b->p99);
+    if (a->max != b->max)       vline(o, "metrics.%s.max: %d vs %d", name, a->max, b->max);
+}
+
+// Compare R against the reference; returns the number of differences
+static int compare(vout_t *o, const proc_table_t *procs, const vrun_t *ref, const vrun_t *R) {
+    const char *rn = eng_names[ENG_THREADED], *en = o->name;
+
+    if (ref->makespan != R->makespan)
+        vline(o, "makespan: %s %d, %s %d", rn, ref->makespan, en, R->makespan);
+
+    int pa, pb, t = first_divergence(ref, R, &pa, &pb);
+    if (t >= 0) {
+        int la, lb;
+        const char *sa = pid_or_idle(procs, pa, &la), *sb = pid_or_idle(procs, pb, &lb);
+        vline(o, "timeline diverges at tick %d: %s runs %.*s, %s runs %.*s", t, rn, la, sa, en, lb, sb);
+    }
+
+    for (int c = 0; c < NCOLS; ++c) {
+        int ndiff = 0, first = -1;
+        for (int i = 0; i < procs->n; ++i) {
+            if (ref->col[c][i] == R->col[c][i]) continue;
+            if (ndiff++ == 0) first = i;
+        }
+        if (ndiff)
+            vline(o, "%s: %d procs differ, first %.*s (%s %d, %s %d)", col_names[c], ndiff,
+                  pt_pid_len(procs, first), pt_pid(procs, first), rn, ref->col[c][first], en, R->col[c][first]);
+    }
+
+    const metrics_t *a = &ref->M, *b = &R->M;
+    if (a->nprocs != b->nprocs)     vline(o, "metrics.nprocs: %lld vs %lld", a->nprocs, b->nprocs);
+    if (a->avg_wait != b->avg_wait) vline(o, "metrics.avg_wait: %.6f vs %.6f", a->avg_wait, b->avg_wait);
+    if (a->avg_resp != b->avg_resp) vline(o, "metrics.avg_resp: %.6f vs %.6f", a->avg_resp, b->avg_resp);
+    if (a->avg_turn != b->avg_turn) vline(o, "metrics.avg_turn: %.6f vs %.6f", a->avg_turn, b->avg_turn);
+    if (a->max_wait != b->max_wait) vline(o, "metrics.max_wait: %d vs %d", a->max_wait, b->max_wait);
+    if (a->max_wait_proc != b->max_wait_proc)
+        vline(o, "metrics.max_wait_proc: %d vs %d", a->max_wait_proc, b->max_wait_proc);
+    if (a->throughput != b->throughput)
+        vline(o, "metrics.throughput: %.6f vs %.6f", a->throughput, b->throughput);
+    if (a->cpu_utilization != b->cpu_utilization)
+        vline(o, "metrics.cpu_utilization: %.6f vs %.6f", a->cpu_utilization, b->cpu_utilization);
+    cmp_dist(o, "wait", &a->wait, &b->wait);
+    cmp_dist(o, "resp", &a->resp, &b->resp);
+    cmp_dist(o, "turn", &a->turn, &b->turn);
+    return o->lines;
+}
+
+// RR: rr_sweep_row at sp->quantum against run_scheduler_events. Context
+// switches are only counted by a SCHED_STATS build. Returns the number of
+// differences.
+static int verify_sweep(vout_t *o, proc_table_t *procs, const sched_params_t *sp) {
+    metrics_acc_t acc;
+    macc_init(&acc);
+    sched_stats_t stats = {0};
+    pt_reset(procs);
+    int makespan = run_scheduler_events(procs, policy_find("rr"), sp, &acc, &stats, NULL, NULL);
+    metrics_t M = metrics_from_acc(&acc, makespan, 1);
+
+    arrival_cursor_t arrivals;
+    arrivals_init(&arrivals, procs);
+    rr_row_t row;
+    rr_sweep_row(procs, &arrivals, sp->quantum, &row);
+    arrivals_destroy(&arrivals);
+
+    const char *en = eng_names[ENG_EVENT];
+    if (row.makespan != makespan) vline(o, "makespan: %s %d, sweep %d", en, makespan, row.makespan);
+    if (row.avg_wait != M.avg_wait) vline(o, "avg_wait: %s %.6f, sweep %.6f", en, M.avg_wait, row.avg_wait);
+    if (row.avg_resp != M.avg_resp) vline(o, "avg_resp: %s %.6f, sweep %.6f", en, M.avg_resp, row.avg_resp);
+    if (row.avg_turn != M.avg_turn) vline(o, "avg_turn: %s %.6f, sweep %.6f", en, M.avg_turn, row.avg_turn);
+    if (stats_available() && row.ctx_switches != stats.context_switches)
+        vline(o, "context switches: %s %lld, sweep %ld", en, stats.context_switches, row.ctx_switches);
+    metrics_free(&M);
+    return o->lines;
+}
+
+// Every engine against the threaded one; returns how many differ. Quiet
+// prints nothing for engines that match, and the heading (if any) only
+// ahead of a mismatch.
+static int verify_table(proc_table_t *procs, const policy_ops_t *policy, const sched_params_t *sp,
+                        int workers, const char *heading, bool quiet) {
+    if (!quiet && heading) { fputs(heading, stdout); heading = NULL; }
+
+    vrun_t ref;
+    vrun(&ref, ENG_THREADED, procs, policy, sp, workers);
+    int bad = 0;
+    for (int e = ENG_THREADED + 1; e < ENG_COUNT; ++e) {
+        vrun_t R;
+        vrun(&R, e, procs, policy, sp, workers);
+        vout_t o = { heading, eng_names[e], 0 };
+        if (compare(&o, procs, &ref, &R)) bad++;
+        else if (!quiet) printf("  %-9s OK\n", eng_names[e]);
+        heading = o.heading;   // NULL once printed
+        vrun_free(&R);
+    }
+    vrun_free(&ref);
+    if (policy == policy_find("rr")) {
+        vout_t o = { heading, "rr-sweep", 0 };
+        if (verify_sweep(&o, procs, sp)) bad++;
+        else if (!quiet) printf("  %-9s OK\n", "rr-sweep");
+    }
+    return bad;
+}
+
+int run_verify(const char *input, const policy_ops_t *policy, const sched_params_t *sp, int workers) {
+    proc_table_t procs;
+    if (load_workload(input, &procs) != 0) {
+        fprintf(stderr, "Failed to load input: %s\n", input);
+        return 1;
+    }
+    if (procs.n == 0) {
+        fprintf(stderr, "No processes found in %s\n", input);
+        pt_free(&procs);
+        return 1;
+    }
+
+    char heading[128];
+    snprintf(heading, sizeof heading, "\n===== %s engine verification: %d processes, reference %s =====\n",
+             policy->label, procs.n, eng_names[ENG_THREADED]);
+    int bad = verify_table(&procs, policy, sp, workers, heading, false);
+    int checked = ENG_COUNT - 1 + (policy == policy_find("rr"));   // + the sweep
+    if (bad) printf("%d of %d engines differ from %s\n", bad, checked, eng_names[ENG_THREADED]);
+    else     printf("All %d engines match %s\n", checked, eng_names[ENG_THREADED]);
+    pt_free(&procs);
+    return bad ? 1 : 0;
+}
+
+static int draw(uint64_t *rng, int lo, int hi) {   // uniform in lo..hi
+    return lo + (int)(wl_next_u64(rng) % (uint64_t)(hi - lo + 1));
+}
+
+int run_verify_fuzz(int iterations, uint64_t seed, const policy_ops_t *only, int workers) {
+    uint64_t rng = seed;
+    int cases = 0, failed = 0;
+
+    for (int it = 0; it < iterations; ++it) {
+        // small workloads so the per-tick inline engine stays cheap; mean
+        // burst and load are exact in the printed genwl arguments
+        wl_params_t wp;
+        wl_defaults(&wp);
+        wp.n = draw(&rng, 1, 300);
+        wp.seed = wl_next_u64(&rng);
+        wp.dist = (wl_dist_t)draw(&rng, WL_EXP, WL_PARETO);
+        wp.mean_burst = draw(&rng, 1, 20);
+        wp.load = draw(&rng, 3, 15) / 10.0;
+        wp.priorities = draw(&rng, 1, 10);
+        wp.edge = draw(&rng, 0, 5) / 100.0;   // zero bursts, negative priorities and arrivals
+        proc_table_t procs;
+        wl_generate(&wp, &procs);
+
+        for (int k = 0; k < policy_count(); ++k) {
+            const policy_ops_t *policy = only ? only : policy_at(k);
+            if (only && k > 0) break;
+
+            // parameters as sched would derive them from the printed flags
+            int q = draw(&rng, 1, 8), aging = policy->uses_aging ? draw(&rng, 0, 8) : 0;
+            int levels = draw(&rng, 1, MLFQ_MAX_LEVELS), boost = draw(&rng, 0, 1) ? draw(&rng, 1, 200) : 0;
+            int latency = draw(&rng, 1, 40), gran = draw(&rng, 1, 8);
+            // a pool smaller than the procs in flight, so the threaded engine
+            // has to take workers from preempted procs (pool_bind's eviction)
+            int w = draw(&rng, 1, 3);
+            if (workers > 0) w = workers;
+            sched_params_t sp;
+            sched_params_init(&sp, q);
+            sp.aging = aging;
+            sp.mlfq_levels = levels;
+            sp.mlfq_boost = boost;
+            sp.cfs_latency = latency;
+            sp.cfs_min_gran = gran;
+
+            char aflag[24] = "";
+            if (aging) snprintf(aflag, sizeof aflag, " -A %d", aging);
+            char heading[512];
+            snprintf(heading, sizeof heading,
+                     "\n===== fuzz case %d: %s, %d processes =====\n"
+                     "  reproduce: genwl -n %ld -s %llu -d %s -b %g -l %.1f -p %d -e %.2f case.csv\n"
+                     "             sched --verify --policy %s -q %d%s -L %d -O %d -l %d -g %d -w %d -i case.csv\n",
+                     cases, policy->label, procs.n, wp.n, (unsigned long long)wp.seed,
+                     wl_dist_name(wp.dist), wp.mean_burst, wp.load, wp.priorities, wp.edge,
+                     policy->name, q, aflag, levels, boost, latency, gran, w);
+            cases++;
+            if (verify_table(&procs, policy, &sp, w, heading, true)) failed++;
+        }
+        pt_free(&procs);
+    }
+
+    printf("\nfuzz: %d workloads, %d cases (seed %llu): %d mismatching\n",
+           iterations, cases, (unsigned long long)seed, failed);
+    return failed ? 1 : 0;
+}
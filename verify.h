@@ -0,0 +1,29 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <stdint.h>
+#include "scheduler_wiring.h"
+
+// Differential check of the engines. One workload runs through the threaded
+// engine (the reference) and through the inline, event and one-CPU SMP
+// engines, and each is compared against the reference: timeline, every
+// process's start, finish, wait and response time, and the metrics_t summary
+// field by field. A mismatch is reported with the first tick the schedules
+// diverge at. Under RR the --quantum-range row for the run's quantum (see
+// rr_sweep.h) is also checked against the event engine.
+
+// --verify: the workload in input with the parsed policy and parameters.
+// workers sizes the threaded engine's pool (see run_scheduler).
+// Returns 0 when every engine matches the reference.
+int run_verify(const char *input, const policy_ops_t *policy, const sched_params_t *sp, int workers);
+
+// --verify --fuzz n[:seed]: n generated workloads (tools/wlgen.h) of random
+// size, burst shape and load, some with zero bursts and negative
+// priorities and arrivals, each through every registered policy (or only
+// policy, if not NULL) with random parameters, threaded with 1..3 workers
+// unless workers > 0 fixes the pool. Every mismatch is reported
+// with the genwl and sched commands that reproduce it. Returns 0 when all
+// cases match.
+int run_verify_fuzz(int iterations, uint64_t seed, const policy_ops_t *policy, int workers);
+
+#endif